@@ -0,0 +1,119 @@
+﻿#include "AnimationClip.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// パックの登録は別スレッドから呼ばれる
+		std::mutex g_clipMutex;
+		HashTable<AssetName, std::unique_ptr<AnimationClip>> g_clips;
+	}
+
+	AnimationClip::AnimationClip()
+		: m_textureName{}
+		, m_frames{}
+		, m_frameEndTimes{}
+		, m_length{ 0.0 }
+		, m_uniformDuration{ 0.0 }
+	{
+	}
+
+	AnimationClip::~AnimationClip()
+	{
+	}
+
+	void AnimationClip::setTextureName(AssetNameView textureName)
+	{
+		m_textureName = textureName;
+	}
+
+	const AssetName& AnimationClip::getTextureName() const
+	{
+		return m_textureName;
+	}
+
+	void AnimationClip::addFrame(const RectF& srcRect, double duration)
+	{
+		DEBUG_BREAK(duration <= 0.0);
+		duration = Max(duration, 0.001);
+
+		if (m_frames.isEmpty())
+		{
+			m_uniformDuration = duration;
+		}
+		else if (m_uniformDuration != duration)
+		{
+			m_uniformDuration = 0.0;
+		}
+
+		m_frames.push_back(srcRect);
+		m_length += duration;
+		m_frameEndTimes.push_back(m_length);
+	}
+
+	size_t AnimationClip::getFrameCount() const
+	{
+		return m_frames.size();
+	}
+
+	double AnimationClip::getLength() const
+	{
+		return m_length;
+	}
+
+	const RectF& AnimationClip::getFrame(double time) const
+	{
+		if (m_frames.isEmpty())
+		{
+			DEBUG_BREAK(true);
+			static const RectF EMPTY_RECT = RectF::Empty();
+			return EMPTY_RECT;
+		}
+
+		double t = std::fmod(time, m_length);
+		if (t < 0.0)
+		{
+			t += m_length;
+		}
+
+		// ほとんどのクリップは 1 コマの長さがそろっているので割り算だけで求める
+		if (0.0 < m_uniformDuration)
+		{
+			const size_t index = static_cast<size_t>(t / m_uniformDuration);
+			return m_frames[Min(index, m_frames.size() - 1)];
+		}
+
+		for (size_t i = 0; i < m_frameEndTimes.size(); ++i)
+		{
+			if (t < m_frameEndTimes[i])
+			{
+				return m_frames[i];
+			}
+		}
+		return m_frames.back();
+	}
+
+	void AnimationClipLibrary::Register(AssetNameView name, std::unique_ptr<AnimationClip>&& pClip)
+	{
+		std::lock_guard lock{ g_clipMutex };
+		g_clips[AssetName{ name }] = std::move(pClip);
+	}
+
+	void AnimationClipLibrary::Unregister(AssetNameView name)
+	{
+		std::lock_guard lock{ g_clipMutex };
+		g_clips.erase(AssetName{ name });
+	}
+
+	const AnimationClip* AnimationClipLibrary::Find(AssetNameView name)
+	{
+		std::lock_guard lock{ g_clipMutex };
+		const auto it = g_clips.find(AssetName{ name });
+		if (it == g_clips.end())
+		{
+			return nullptr;
+		}
+		return it->second.get();
+	}
+}
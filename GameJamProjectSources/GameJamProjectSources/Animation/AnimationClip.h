@@ -0,0 +1,57 @@
+﻿#pragma once
+#ifndef BNSCUP_ANIMATIONCLIP_H_
+#define BNSCUP_ANIMATIONCLIP_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief テクスチャの切り出し位置を順に並べたループアニメーション
+	 * @details 状態を持たず、経過時間から今の絵を求める。
+	 *          同じ見た目のユニットはすべて同じクリップを参照する。
+	 */
+	class AnimationClip
+	{
+	public:
+
+		explicit AnimationClip();
+		virtual ~AnimationClip();
+
+		void setTextureName(AssetNameView textureName);
+		const AssetName& getTextureName() const;
+
+		void addFrame(const RectF& srcRect, double duration);
+
+		size_t getFrameCount() const;
+		double getLength() const;
+
+		// time 秒時点の切り出し位置（ループ再生）
+		const RectF& getFrame(double time) const;
+
+	private:
+
+		AssetName m_textureName;
+		Array<RectF> m_frames;
+		Array<double> m_frameEndTimes;
+		double m_length;
+		double m_uniformDuration;	// すべて同じ長さなら 1 コマの長さ、ばらばらなら 0
+	};
+
+	/**
+	 * @brief アセットパックから読み込んだアニメーションクリップの置き場
+	 * @details AudioAsset などと同じく名前で登録し、参照側は一度だけ引いてポインタを持つ。
+	 */
+	class AnimationClipLibrary
+	{
+	public:
+
+		static void Register(AssetNameView name, std::unique_ptr<AnimationClip>&& pClip);
+		static void Unregister(AssetNameView name);
+
+		// 見つからない場合は nullptr
+		static const AnimationClip* Find(AssetNameView name);
+	};
+}
+
+#endif // !BNSCUP_ANIMATIONCLIP_H_
@@ -1,5 +1,7 @@
 ﻿#include "AssetRegister.h"
 #include "../Common/Common.h"
+#include "../Animation/AnimationClip.h"
+#include "../Particle/ParticleEmitter.h"
 namespace
 {
 	bool PackLoadRegist(const Array<FilePath>& files, Array<bnscup::AssetPackInfo>& packInfos)
@@ -116,6 +118,81 @@ namespace
 					TextureAsset::Register(assetName, std::move(assetData));
 				}
 			}
+			if (jsonDocument.hasElement(U"animationClipDatas")
+				and jsonDocument[U"animationClipDatas"].isArray())
+			{
+				const size_t size = jsonDocument[U"animationClipDatas"].size();
+
+				for (size_t i : step(size))
+				{
+					const auto& animationClipDataDocument = jsonDocument[U"animationClipDatas"][i];
+
+					std::unique_ptr<bnscup::AnimationClip> clip;
+					clip.reset(new bnscup::AnimationClip());
+
+					String assetName = animationClipDataDocument[U"assetName"].getOr<String>(U"none");
+					clip->setTextureName(animationClipDataDocument[U"texture"].getOr<String>(U""));
+
+					// コマごとの duration が無ければクリップ共通の長さを使う
+					const double frameDuration = animationClipDataDocument[U"frameDuration"].getOr<double>(0.1);
+					const auto& framesDocument = animationClipDataDocument[U"frames"];
+					for (size_t k : step(framesDocument.size()))
+					{
+						const auto& frameDocument = framesDocument[k];
+						const RectF srcRect
+						{
+							frameDocument[U"x"].getOr<double>(0.0),
+							frameDocument[U"y"].getOr<double>(0.0),
+							frameDocument[U"w"].getOr<double>(0.0),
+							frameDocument[U"h"].getOr<double>(0.0),
+						};
+						clip->addFrame(srcRect, frameDocument[U"duration"].getOr<double>(frameDuration));
+					}
+
+					packInfo.animationClipNames.push_back(assetName);
+					bnscup::AnimationClipLibrary::Register(assetName, std::move(clip));
+				}
+			}
+			if (jsonDocument.hasElement(U"particleEmitterDatas")
+				and jsonDocument[U"particleEmitterDatas"].isArray())
+			{
+				const size_t size = jsonDocument[U"particleEmitterDatas"].size();
+
+				for (size_t i : step(size))
+				{
+					const auto& emitterDataDocument = jsonDocument[U"particleEmitterDatas"][i];
+					const auto readColor = [](const JSON& colorDocument, const ColorF& defaultColor)
+						{
+							const Color color = defaultColor.toColor();
+							return ColorF{ Color{
+								colorDocument[U"r"].getOr<uint8>(color.r),
+								colorDocument[U"g"].getOr<uint8>(color.g),
+								colorDocument[U"b"].getOr<uint8>(color.b),
+								colorDocument[U"a"].getOr<uint8>(color.a) } };
+						};
+
+					bnscup::ParticleEmitterDesc desc;
+					String assetName = emitterDataDocument[U"assetName"].getOr<String>(U"none");
+					desc.count = emitterDataDocument[U"count"].getOr<int32>(desc.count);
+					desc.lifeMin = emitterDataDocument[U"life"][U"min"].getOr<double>(desc.lifeMin);
+					desc.lifeMax = emitterDataDocument[U"life"][U"max"].getOr<double>(desc.lifeMin);
+					desc.speedMin = emitterDataDocument[U"speed"][U"min"].getOr<double>(desc.speedMin);
+					desc.speedMax = emitterDataDocument[U"speed"][U"max"].getOr<double>(desc.speedMin);
+					desc.angle = emitterDataDocument[U"angle"].getOr<double>(desc.angle);
+					desc.spread = emitterDataDocument[U"spread"].getOr<double>(desc.spread);
+					desc.radius = emitterDataDocument[U"radius"].getOr<double>(desc.radius);
+					desc.gravity = emitterDataDocument[U"gravity"].getOr<double>(desc.gravity);
+					desc.drag = emitterDataDocument[U"drag"].getOr<double>(desc.drag);
+					desc.sizeStart = emitterDataDocument[U"size"][U"start"].getOr<double>(desc.sizeStart);
+					desc.sizeEnd = emitterDataDocument[U"size"][U"end"].getOr<double>(desc.sizeEnd);
+					desc.colorStart = readColor(emitterDataDocument[U"color"][U"start"], desc.colorStart);
+					desc.colorEnd = readColor(emitterDataDocument[U"color"][U"end"], desc.colorEnd);
+					desc.isAdditive = emitterDataDocument[U"additive"].getOr<bool>(desc.isAdditive);
+
+					packInfo.particleEmitterNames.push_back(assetName);
+					bnscup::ParticleEmitterLibrary::Register(assetName, desc);
+				}
+			}
 			packInfos.push_back(packInfo);
 		}
 		return true;
@@ -156,6 +233,14 @@ namespace bnscup
 			{
 				TextureAsset::Unregister(assetName);
 			}
+			for (const auto& assetName : packInfo.animationClipNames)
+			{
+				AnimationClipLibrary::Unregister(assetName);
+			}
+			for (const auto& assetName : packInfo.particleEmitterNames)
+			{
+				ParticleEmitterLibrary::Unregister(assetName);
+			}
 		}
 	}
 
@@ -12,6 +12,8 @@ namespace bnscup
 		Array<AssetName> audioAssetNames;
 		Array<AssetName> fontAssetNames;
 		Array<AssetName> textureAssetNames;
+		Array<AssetName> animationClipNames;
+		Array<AssetName> particleEmitterNames;
 	};
 
 	class AssetRegister
@@ -1,75 +1,95 @@
 ﻿#include "Button.h"
+#include "../Sound/SoundManager.h"
 
 namespace bnscup
 {
 	namespace
 	{
-		constexpr const char32_t* SOUND_OK = U"sd_button_ok";
-		constexpr const char32_t* SOUND_CANCEL = U"sd_button_cancel";
-		constexpr const char32_t* SOUND_SELECT = U"sd_button_select";
+		// Button::Sounds の順
+		constexpr const char32_t* SOUND_NAME_TABLE[] =
+		{
+			U"sd_button_ok",
+			U"sd_button_cancel",
+			U"sd_button_select",
+		};
 
-		static const HashTable<Button::Sounds, AssetName> SOUND_TABLE =
+		// RegisterSounds() で引いた番号
+		SoundId g_soundIds[std::size(SOUND_NAME_TABLE)] =
 		{
-			{ Button::Sounds::OK, SOUND_OK },
-			{ Button::Sounds::Cancel, SOUND_CANCEL },
-			{ Button::Sounds::Select, SOUND_SELECT },
+			INVALID_SOUND_ID,
+			INVALID_SOUND_ID,
+			INVALID_SOUND_ID,
 		};
 	}
 
+	uint8 Button::m_sPendingSounds = 0;
+
 	Button::Button(const RectF& rect)
-		: m_collisionType{ CollisionType::Rect }
+		: m_widgetId{ UIInputRouter::Register() }
+		, m_collisionType{ CollisionType::Rect }
 		, m_rect{ rect }
 		, m_circle{ 0, 0, 0 }
 		, m_isHold{ false }
+		, m_isPressed{ false }
+		, m_isHover{ false }
 		, m_isSelected{ false }
 		, m_isEnable{ true }
+		, m_visualBits{ 0 }
+		, m_isVisualChanged{ true }
 	{
 	}
 
 	Button::Button(const Circle& circle)
-		: m_collisionType{ CollisionType::Circle }
+		: m_widgetId{ UIInputRouter::Register() }
+		, m_collisionType{ CollisionType::Circle }
 		, m_rect{ RectF::Empty() }
 		, m_circle{ circle }
 		, m_isHold{ false }
+		, m_isPressed{ false }
+		, m_isHover{ false }
 		, m_isSelected{ false }
 		, m_isEnable{ true }
+		, m_visualBits{ 0 }
+		, m_isVisualChanged{ true }
 	{
 	}
 
 	Button::~Button()
 	{
+		UIInputRouter::Unregister(m_widgetId);
 	}
 
 	void Button::update()
 	{
-		if (not(m_isEnable))
+		// 今の形を知らせて、ルーターが配った結果だけを見る
+		if (m_collisionType == CollisionType::Rect)
 		{
-			m_isHold = false;
-			m_isSelected = false;
-			return;
+			UIInputRouter::Activate(m_widgetId, m_rect, m_isEnable);
 		}
-
-		m_isSelected = false;
-		if (MouseL.up())
+		else
 		{
-			if (m_isHold)
-			{
-				bool isRectSelected = (m_collisionType == CollisionType::Rect) and m_rect.mouseOver();
-				bool isCircleSelected = (m_collisionType == CollisionType::Circle) and m_circle.mouseOver();
-				if (isRectSelected or isCircleSelected) {
-					m_isSelected = true;
-				}
-			}
-			m_isHold = false;
+			UIInputRouter::Activate(m_widgetId, m_circle, m_isEnable);
 		}
 
-		if (not(m_isHold))
+		if (m_isEnable)
 		{
-			bool isRectHold = (m_collisionType == CollisionType::Rect) and m_rect.leftClicked();
-			bool isCircleHold = (m_collisionType == CollisionType::Circle) and m_circle.leftClicked();
-
-			m_isHold = (isRectHold or isCircleHold);
+			m_isSelected = UIInputRouter::IsClicked(m_widgetId);
+			m_isHold = UIInputRouter::IsHeld(m_widgetId);
+			m_isPressed = UIInputRouter::IsPressed(m_widgetId);
+			m_isHover = UIInputRouter::IsHovered(m_widgetId);
 		}
+		else
+		{
+			m_isHold = false;
+			m_isPressed = false;
+			m_isHover = false;
+			m_isSelected = false;
+		}
+
+		// 見た目が変わったときだけ描き直せるように覚えておく
+		const uint8 visualBits = static_cast<uint8>((m_isHold ? 1u : 0u) | (m_isHover ? 2u : 0u) | (m_isEnable ? 4u : 0u));
+		m_isVisualChanged = (visualBits != m_visualBits);
+		m_visualBits = visualBits;
 	}
 
 	void Button::setEnable(bool enable)
@@ -82,13 +102,33 @@ namespace bnscup
 		return m_isHold;
 	}
 
+	bool Button::isHover() const
+	{
+		return m_isHover;
+	}
+
+	bool Button::isVisualChanged() const
+	{
+		return m_isVisualChanged;
+	}
+
 	bool Button::isSelected(Sounds sd) const
 	{
 		if (not(m_isSelected))
 		{
 			return false;
 		}
-		AudioAsset(SOUND_TABLE.at(sd)).playOneShot();
+		m_sPendingSounds |= static_cast<uint8>(1u << FromEnum(sd));
+		return true;
+	}
+
+	bool Button::isPressed(Sounds sd) const
+	{
+		if (not(m_isPressed))
+		{
+			return false;
+		}
+		m_sPendingSounds |= static_cast<uint8>(1u << FromEnum(sd));
 		return true;
 	}
 
@@ -117,6 +157,30 @@ namespace bnscup
 		return m_circle;
 	}
 
+	void Button::RegisterSounds()
+	{
+		for (size_t i : step(std::size(SOUND_NAME_TABLE)))
+		{
+			g_soundIds[i] = SoundManager::Register(SOUND_NAME_TABLE[i], SoundCategory::UI, 10, 1.0, SoundManager::Persistent::Yes);
+		}
+	}
+
+	void Button::FlushSounds()
+	{
+		if (m_sPendingSounds == 0)
+		{
+			return;
+		}
+		for (size_t i : step(std::size(g_soundIds)))
+		{
+			if (m_sPendingSounds & (1u << i))
+			{
+				SoundManager::Play(g_soundIds[i]);
+			}
+		}
+		m_sPendingSounds = 0;
+	}
+
 }
 
 
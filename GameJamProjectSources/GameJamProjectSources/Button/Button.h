@@ -3,9 +3,15 @@
 #define BNSCUP_BUTTON_H_
 
 #include <Siv3D.hpp>
+#include "UIInputRouter.h"
 
 namespace bnscup
 {
+	/**
+	 * @brief 四角か円の当たり判定を持つボタン
+	 * @details マウスは自分では見ず、UIInputRouter が当たり判定をして届けた結果を受け取る。
+	 *          表示している間は毎フレーム update() を呼ぶこと。
+	 */
 	class Button
 	{
 	public:
@@ -31,14 +37,28 @@ namespace bnscup
 		explicit Button(const Circle& circle);
 		virtual ~Button();
 
+		// UIInputRouter に登録した番号を持つので複製しない
+		Button(const Button&) = delete;
+		Button& operator=(const Button&) = delete;
+
 		void update();
 
 		void setEnable(bool enable);
 
 		bool isHold() const;
 
+		// カーソルが乗っているか
+		bool isHover() const;
+
+		// 前の update() から見た目に関わる状態（乗っている、押されている、有効）が変わったか
+		bool isVisualChanged() const;
+
+		// 選ばれたときの音はここでは鳴らさず、FlushSounds() でまとめて鳴らす
 		bool isSelected(Sounds sd) const;
 
+		// 離すのを待たずに、押したフレームだけ true（音は isSelected() と同じ扱い）
+		bool isPressed(Sounds sd) const;
+
 		bool isEnable() const;
 
 		RectF& getRect();
@@ -47,14 +67,27 @@ namespace bnscup
 		Circle& getCircle();
 		const Circle& getCircle() const;
 
+		// 共通パックを読み込んだあとに1回だけ呼び、ボタンの音を引いておく
+		static void RegisterSounds();
+
+		// フレーム中に選ばれたボタンの音を鳴らす（同じ音は1回だけ）
+		static void FlushSounds();
+
 	private:
 
+		static uint8 m_sPendingSounds;
+
+		UIWidgetId m_widgetId;
 		CollisionType m_collisionType;
 		RectF m_rect;
 		Circle m_circle;
 		bool m_isHold;
+		bool m_isPressed;
+		bool m_isHover;
 		bool m_isSelected;
 		bool m_isEnable;
+		uint8 m_visualBits;		// 前の update() での見た目の状態
+		bool m_isVisualChanged;
 	};
 }
 
@@ -0,0 +1,284 @@
+﻿#include "UIInputRouter.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// 当たり判定の格子（ウィンドウを 64 ピクセルごとに区切る）
+		constexpr int32 CELL_SIZE = 64;
+		constexpr int32 GRID_W = static_cast<int32>((WINDOW_SIZE_W + CELL_SIZE - 1) / CELL_SIZE);
+		constexpr int32 GRID_H = static_cast<int32>((WINDOW_SIZE_H + CELL_SIZE - 1) / CELL_SIZE);
+
+		enum class ShapeType : uint8
+		{
+			None,
+			Rect,
+			Circle,
+		};
+
+		struct Widget
+		{
+			ShapeType shapeType = ShapeType::None;
+			RectF rect = RectF::Empty();
+			Circle circle{ 0, 0, 0 };
+			bool isAlive = false;
+			bool isEnable = false;
+			uint64 activeFrame = 0;		// 最後に Activate() されたフレーム
+			uint64 order = 0;			// 登録した順（大きいほど上）
+		};
+
+		Array<Widget> g_widgets;
+		Array<UIWidgetId> g_freeIds;
+		uint64 g_orderCounter = 0;
+
+		Array<Array<UIWidgetId>> g_cells;
+		bool g_isGridDirty = true;
+
+		// フレームごとの入力の結果
+		uint64 g_resolvedFrame = 0xFFFFFFFFFFFFFFFF;
+		UIWidgetId g_pressedId = INVALID_UI_WIDGET_ID;
+		uint64 g_pressedFrame = 0xFFFFFFFFFFFFFFFF;
+		UIWidgetId g_clickedId = INVALID_UI_WIDGET_ID;
+		UIWidgetId g_hoveredId = INVALID_UI_WIDGET_ID;
+		Vec2 g_lastCursorPos{ -1, -1 };
+
+		RectF GetBoundingRect(const Widget& widget)
+		{
+			if (widget.shapeType == ShapeType::Circle)
+			{
+				return widget.circle.boundingRect();
+			}
+			return widget.rect;
+		}
+
+		void RebuildGrid()
+		{
+			if (g_cells.size() != static_cast<size_t>(GRID_W * GRID_H))
+			{
+				g_cells.resize(GRID_W * GRID_H);
+			}
+			for (auto& cell : g_cells)
+			{
+				cell.clear();
+			}
+			for (size_t i = 0; i < g_widgets.size(); ++i)
+			{
+				const auto& widget = g_widgets[i];
+				if (not(widget.isAlive) or widget.shapeType == ShapeType::None)
+				{
+					continue;
+				}
+				const RectF bounds = GetBoundingRect(widget);
+				const int32 x0 = Clamp(static_cast<int32>(bounds.x) / CELL_SIZE, 0, GRID_W - 1);
+				const int32 y0 = Clamp(static_cast<int32>(bounds.y) / CELL_SIZE, 0, GRID_H - 1);
+				const int32 x1 = Clamp(static_cast<int32>(bounds.x + bounds.w) / CELL_SIZE, 0, GRID_W - 1);
+				const int32 y1 = Clamp(static_cast<int32>(bounds.y + bounds.h) / CELL_SIZE, 0, GRID_H - 1);
+				for (int32 y = y0; y <= y1; ++y)
+				{
+					for (int32 x = x0; x <= x1; ++x)
+					{
+						g_cells[y * GRID_W + x].push_back(static_cast<UIWidgetId>(i));
+					}
+				}
+			}
+			g_isGridDirty = false;
+		}
+
+		// カーソルの位置にある一番上の部品
+		UIWidgetId FindTopWidget(const Vec2& cursorPos, uint64 frame)
+		{
+			if (cursorPos.x < 0 or cursorPos.y < 0)
+			{
+				return INVALID_UI_WIDGET_ID;
+			}
+			const int32 x = static_cast<int32>(cursorPos.x) / CELL_SIZE;
+			const int32 y = static_cast<int32>(cursorPos.y) / CELL_SIZE;
+			if (GRID_W <= x or GRID_H <= y)
+			{
+				return INVALID_UI_WIDGET_ID;
+			}
+
+			UIWidgetId topId = INVALID_UI_WIDGET_ID;
+			uint64 topOrder = 0;
+			for (const UIWidgetId id : g_cells[y * GRID_W + x])
+			{
+				const auto& widget = g_widgets[id];
+				// 前のフレームから Activate() されていない部品は表示されていない
+				if (not(widget.isEnable) or (widget.activeFrame + 1) < frame)
+				{
+					continue;
+				}
+				const bool isHit = (widget.shapeType == ShapeType::Rect)
+					? widget.rect.intersects(cursorPos)
+					: widget.circle.intersects(cursorPos);
+				if (isHit and (topId == INVALID_UI_WIDGET_ID or topOrder < widget.order))
+				{
+					topId = id;
+					topOrder = widget.order;
+				}
+			}
+			return topId;
+		}
+
+		// フレームの最初の問い合わせで入力を読む
+		void Resolve()
+		{
+			const uint64 frame = Scene::FrameCount();
+			if (g_resolvedFrame == frame)
+			{
+				return;
+			}
+			g_resolvedFrame = frame;
+			g_clickedId = INVALID_UI_WIDGET_ID;
+
+			const bool isDown = MouseL.down();
+			const bool isUp = MouseL.up();
+			const Vec2 cursorPos = Cursor::PosF();
+			const bool isMoved = (cursorPos != g_lastCursorPos);
+			// 乗っていた部品が表示されなくなった場合も引き直す
+			const bool isHoverLost = (g_hoveredId != INVALID_UI_WIDGET_ID)
+				and ((g_widgets[g_hoveredId].activeFrame + 1) < frame);
+			if (not(isDown) and not(isUp) and not(isMoved) and not(isHoverLost))
+			{
+				return;
+			}
+			g_lastCursorPos = cursorPos;
+
+			if (g_isGridDirty)
+			{
+				RebuildGrid();
+			}
+			const UIWidgetId hitId = FindTopWidget(cursorPos, frame);
+			g_hoveredId = hitId;
+			if (isUp)
+			{
+				if (g_pressedId != INVALID_UI_WIDGET_ID and g_pressedId == hitId)
+				{
+					g_clickedId = hitId;
+				}
+				g_pressedId = INVALID_UI_WIDGET_ID;
+			}
+			if (isDown)
+			{
+				g_pressedId = hitId;
+				g_pressedFrame = frame;
+			}
+		}
+
+		bool IsValidId(UIWidgetId id)
+		{
+			return (id < g_widgets.size()) and g_widgets[id].isAlive;
+		}
+	}
+
+	UIWidgetId UIInputRouter::Register()
+	{
+		UIWidgetId id = INVALID_UI_WIDGET_ID;
+		if (g_freeIds.isEmpty())
+		{
+			id = static_cast<UIWidgetId>(g_widgets.size());
+			g_widgets.emplace_back();
+		}
+		else
+		{
+			id = g_freeIds.back();
+			g_freeIds.pop_back();
+		}
+		g_widgets[id] = Widget{};
+		g_widgets[id].isAlive = true;
+		g_widgets[id].order = ++g_orderCounter;
+		return id;
+	}
+
+	void UIInputRouter::Unregister(UIWidgetId id)
+	{
+		if (not(IsValidId(id)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		g_widgets[id] = Widget{};
+		g_freeIds.push_back(id);
+		g_isGridDirty = true;
+		if (g_pressedId == id)
+		{
+			g_pressedId = INVALID_UI_WIDGET_ID;
+		}
+		if (g_clickedId == id)
+		{
+			g_clickedId = INVALID_UI_WIDGET_ID;
+		}
+		if (g_hoveredId == id)
+		{
+			g_hoveredId = INVALID_UI_WIDGET_ID;
+		}
+	}
+
+	void UIInputRouter::Activate(UIWidgetId id, const RectF& rect, bool isEnable)
+	{
+		if (not(IsValidId(id)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		Resolve();
+		auto& widget = g_widgets[id];
+		if (widget.shapeType != ShapeType::Rect or widget.rect != rect)
+		{
+			widget.shapeType = ShapeType::Rect;
+			widget.rect = rect;
+			g_isGridDirty = true;
+		}
+		widget.isEnable = isEnable;
+		widget.activeFrame = Scene::FrameCount();
+	}
+
+	void UIInputRouter::Activate(UIWidgetId id, const Circle& circle, bool isEnable)
+	{
+		if (not(IsValidId(id)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		Resolve();
+		auto& widget = g_widgets[id];
+		if (widget.shapeType != ShapeType::Circle or widget.circle != circle)
+		{
+			widget.shapeType = ShapeType::Circle;
+			widget.circle = circle;
+			g_isGridDirty = true;
+		}
+		widget.isEnable = isEnable;
+		widget.activeFrame = Scene::FrameCount();
+	}
+
+	bool UIInputRouter::IsHeld(UIWidgetId id)
+	{
+		Resolve();
+		return (id != INVALID_UI_WIDGET_ID) and (g_pressedId == id);
+	}
+
+	bool UIInputRouter::IsPressed(UIWidgetId id)
+	{
+		Resolve();
+		return IsHeld(id) and (g_pressedFrame == g_resolvedFrame);
+	}
+
+	bool UIInputRouter::IsClicked(UIWidgetId id)
+	{
+		Resolve();
+		return (id != INVALID_UI_WIDGET_ID) and (g_clickedId == id);
+	}
+
+	bool UIInputRouter::IsHovered(UIWidgetId id)
+	{
+		Resolve();
+		return (id != INVALID_UI_WIDGET_ID) and (g_hoveredId == id);
+	}
+
+	size_t UIInputRouter::GetWidgetCount()
+	{
+		return g_widgets.size() - g_freeIds.size();
+	}
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#ifndef BNSCUP_UIINPUTROUTER_H_
+#define BNSCUP_UIINPUTROUTER_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	using UIWidgetId = uint32;
+	constexpr UIWidgetId INVALID_UI_WIDGET_ID = 0xFFFFFFFF;
+
+	/**
+	 * @brief UI の当たり判定とマウス入力の配り先をまとめて受け持つ
+	 * @details マウスの状態はフレームの最初の問い合わせで1回だけ読み、押した・離したフレームだけ
+	 *          カーソルの位置の部品を格子で引いて1つに決める。結果は当たった部品にだけ届く。
+	 *          部品は毎フレーム Activate() で形と有効かどうかを知らせ、前のフレームか今のフレームに
+	 *          知らせたものだけが当たり判定の対象になる（表示していない部品は当たらない）。
+	 *          重なっている場合は後から登録した部品を上とする。
+	 *          カーソルが乗っている部品はカーソルが動いたフレームだけ引き直す。
+	 */
+	class UIInputRouter
+	{
+	public:
+
+		static UIWidgetId Register();
+		static void Unregister(UIWidgetId id);
+
+		// 形が変わったときだけ格子を作り直す
+		static void Activate(UIWidgetId id, const RectF& rect, bool isEnable);
+		static void Activate(UIWidgetId id, const Circle& circle, bool isEnable);
+
+		// 押されたままか（離したフレームは false）
+		static bool IsHeld(UIWidgetId id);
+		// このフレームで押されたか
+		static bool IsPressed(UIWidgetId id);
+		// このフレームで、押したときと同じ部品の上で離されたか
+		static bool IsClicked(UIWidgetId id);
+		// カーソルが乗っているか（重なっている場合は一番上の部品だけ）
+		static bool IsHovered(UIWidgetId id);
+
+		// 登録されている部品の数（確認用）
+		static size_t GetWidgetCount();
+	};
+}
+
+#endif // !BNSCUP_UIINPUTROUTER_H_
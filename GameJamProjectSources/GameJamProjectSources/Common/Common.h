@@ -18,6 +18,20 @@ namespace bnscup
 	constexpr unsigned long WINDOW_SIZE_H =  960;
 
 	constexpr const char32_t* GAME_TITLE = U"きゅうじょたい";
+
+	// シーン用アリーナの1ブロックの大きさ
+	constexpr unsigned long SCENE_ARENA_BLOCK_SIZE = 256 * 1024;
+
+	// 時間で動くものを進める1ステップの長さ（秒）と、1フレームで進める最大ステップ数
+	constexpr double FIXED_STEP_TIME = 1.0 / 120.0;
+	constexpr int MAX_FIXED_STEP_COUNT = 8;
+
+	// ゲーム画面で同時に出せるパーティクルの数
+	constexpr unsigned long PARTICLE_CAPACITY = 4096;
+
+	// 移動の演出中に溜めておける方向の入力の数と、溜まっている間の移動の速さの倍率（1.0 なら等速のまま続けて動く）
+	constexpr unsigned long MOVE_BUFFER_CAPACITY = 4;
+	constexpr double CHAINED_MOVE_SPEED_SCALE = 2.0;
 }
 
 #endif // !BNSCUP_COMMON_H_
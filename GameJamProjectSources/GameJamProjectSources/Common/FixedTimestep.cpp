@@ -0,0 +1,57 @@
+﻿#include "FixedTimestep.h"
+#include "Common.h"
+
+namespace bnscup
+{
+	FixedTimestep::FixedTimestep(double stepTime, int32 maxStepCount)
+		: m_stepTime{ stepTime }
+		, m_maxStepCount{ maxStepCount }
+		, m_accumulator{ 0.0 }
+		, m_stepCount{ 0 }
+	{
+		DEBUG_BREAK(m_stepTime <= 0.0);
+		DEBUG_BREAK(m_maxStepCount <= 0);
+	}
+
+	FixedTimestep::~FixedTimestep()
+	{
+	}
+
+	void FixedTimestep::advance(double frameTime)
+	{
+		m_accumulator += Max(frameTime, 0.0);
+		m_stepCount = 0;
+		while (m_stepTime <= m_accumulator and m_stepCount < m_maxStepCount)
+		{
+			m_accumulator -= m_stepTime;
+			m_stepCount++;
+		}
+
+		// 長く止まったフレームの分は追いかけずに捨てる（端数だけ残す）
+		if (m_stepTime <= m_accumulator)
+		{
+			m_accumulator = std::fmod(m_accumulator, m_stepTime);
+		}
+	}
+
+	void FixedTimestep::reset()
+	{
+		m_accumulator = 0.0;
+		m_stepCount = 0;
+	}
+
+	int32 FixedTimestep::getStepCount() const
+	{
+		return m_stepCount;
+	}
+
+	double FixedTimestep::getStepTime() const
+	{
+		return m_stepTime;
+	}
+
+	double FixedTimestep::getAlpha() const
+	{
+		return Clamp(m_accumulator / m_stepTime, 0.0, 1.0);
+	}
+}
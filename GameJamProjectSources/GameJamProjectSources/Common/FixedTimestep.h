@@ -0,0 +1,41 @@
+﻿#pragma once
+#ifndef BNSCUP_FIXEDTIMESTEP_H_
+#define BNSCUP_FIXEDTIMESTEP_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief フレームの経過時間を決まった長さのステップに切り分ける
+	 * @details 毎フレーム advance() を呼び、そのフレームで進めるステップ数と、
+	 *          余った時間の割合（描画の補間に使う）を求める。
+	 *          ステップの長さは常に同じなので、フレームレートによらず同じ動きになる。
+	 */
+	class FixedTimestep
+	{
+	public:
+
+		explicit FixedTimestep(double stepTime, int32 maxStepCount);
+		virtual ~FixedTimestep();
+
+		void advance(double frameTime);
+		void reset();
+
+		// このフレームで進めるステップ数
+		int32 getStepCount() const;
+		double getStepTime() const;
+
+		// 最後のステップから次のステップまでのどこにいるか（0.0 ～ 1.0）
+		double getAlpha() const;
+
+	private:
+
+		double m_stepTime;
+		int32 m_maxStepCount;
+		double m_accumulator;
+		int32 m_stepCount;
+	};
+}
+
+#endif // !BNSCUP_FIXEDTIMESTEP_H_
@@ -0,0 +1,143 @@
+﻿#include "InputQueue.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		struct KeyBinding
+		{
+			Input input;
+			InputAction action;
+		};
+
+		// 矢印キーと WASD は同じ操作
+		static const KeyBinding KEY_BINDING_TABLE[] =
+		{
+			{ KeyUp,	InputAction::Up },
+			{ KeyW,		InputAction::Up },
+			{ KeyRight,	InputAction::Right },
+			{ KeyD,		InputAction::Right },
+			{ KeyDown,	InputAction::Down },
+			{ KeyS,		InputAction::Down },
+			{ KeyLeft,	InputAction::Left },
+			{ KeyA,		InputAction::Left },
+		};
+
+		// ゲームパッドの十字キーを並べる順
+		static const InputAction DPAD_ACTION_TABLE[] =
+		{
+			InputAction::Up,
+			InputAction::Right,
+			InputAction::Down,
+			InputAction::Left,
+		};
+	}
+
+	InputQueue::InputQueue()
+		: m_events{}
+		, m_readIndex{ 0 }
+		, m_pushedBits{ 0 }
+		, m_delayStats{}
+	{
+		m_events.reserve(CAPACITY);
+	}
+
+	InputQueue::~InputQueue()
+	{
+	}
+
+	void InputQueue::poll()
+	{
+		clear();
+
+		for (const auto& binding : KEY_BINDING_TABLE)
+		{
+			if (binding.input.down())
+			{
+				push(binding.action);
+			}
+		}
+
+		// ゲームパッドの十字キー（XInput 対応のものは XInput 側でも取れるが、同じ操作は1つにまとまる）
+		if (const auto& gamepad = Gamepad(0))
+		{
+			const Input dpadInputs[] = { gamepad.povUp, gamepad.povRight, gamepad.povDown, gamepad.povLeft };
+			for (size_t i : step(std::size(DPAD_ACTION_TABLE)))
+			{
+				if (dpadInputs[i].down())
+				{
+					push(DPAD_ACTION_TABLE[i]);
+				}
+			}
+		}
+		if (const auto& controller = XInput(0); controller.isConnected())
+		{
+			const Input dpadInputs[] = { controller.buttonUp, controller.buttonRight, controller.buttonDown, controller.buttonLeft };
+			for (size_t i : step(std::size(DPAD_ACTION_TABLE)))
+			{
+				if (dpadInputs[i].down())
+				{
+					push(DPAD_ACTION_TABLE[i]);
+				}
+			}
+		}
+	}
+
+	void InputQueue::push(InputAction action)
+	{
+		if (action == InputAction::None or action == InputAction::Count)
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		const uint8 bit = static_cast<uint8>(1u << FromEnum(action));
+		if ((m_pushedBits & bit) or CAPACITY <= m_events.size())
+		{
+			return;
+		}
+		m_pushedBits |= bit;
+		m_events.push_back(InputEvent{ action, Scene::FrameCount() });
+	}
+
+	bool InputQueue::pop(InputEvent& event)
+	{
+		if (isEmpty())
+		{
+			return false;
+		}
+		event = m_events[m_readIndex];
+		++m_readIndex;
+		return true;
+	}
+
+	bool InputQueue::isEmpty() const
+	{
+		return (m_events.size() <= m_readIndex);
+	}
+
+	void InputQueue::clear()
+	{
+		m_events.clear();
+		m_readIndex = 0;
+		m_pushedBits = 0;
+	}
+
+	void InputQueue::recordDelay(const InputEvent& event)
+	{
+		const uint64 frame = Scene::FrameCount();
+		const uint64 delayFrames = (event.frame < frame) ? (frame - event.frame) : 0;
+		m_delayStats.count++;
+		m_delayStats.totalFrames += delayFrames;
+		m_delayStats.maxFrames = Max(m_delayStats.maxFrames, delayFrames);
+		if (0 < delayFrames)
+		{
+			m_delayStats.delayedCount++;
+		}
+	}
+
+	const InputDelayStats& InputQueue::getDelayStats() const
+	{
+		return m_delayStats;
+	}
+}
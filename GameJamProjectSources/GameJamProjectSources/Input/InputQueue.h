@@ -0,0 +1,85 @@
+﻿#pragma once
+#ifndef BNSCUP_INPUTQUEUE_H_
+#define BNSCUP_INPUTQUEUE_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	enum class InputAction : uint8
+	{
+		None = 0,
+		Up,
+		Right,
+		Down,
+		Left,
+
+		Count,
+	};
+
+	struct InputEvent
+	{
+		InputAction action;
+		uint64 frame;		// 積んだフレーム
+	};
+
+	/**
+	 * @brief 入力を積んでから動き始めるまでのフレーム数
+	 * @details 入力はフレームの最初にまとめて読むので、フレーム内の時刻を測っても実際に押してからの時間にはならない。
+	 *          そのためフレーム単位で数える（0 なら押したフレームで動き始めている）。
+	 */
+	struct InputDelayStats
+	{
+		size_t count = 0;
+		uint64 totalFrames = 0;
+		uint64 maxFrames = 0;
+		size_t delayedCount = 0;	// 積んだフレームより後で動き始めた回数
+
+		String format() const
+		{
+			const double averageFrames = (count == 0) ? 0.0 : (static_cast<double>(totalFrames) / count);
+			return U"count {}, average {:.2f} frames, max {} frames, delayed {}"_fmt(count, averageFrames, maxFrames, delayedCount);
+		}
+	};
+
+	/**
+	 * @brief キーボード、ゲームパッド、画面のボタンからの方向の入力を、押した順に積む
+	 * @details フレームの最初に poll() を1回呼び、押された瞬間（離したときではない）の入力を積む。
+	 *          矢印キー、WASD、ゲームパッドの十字キーは同じ操作になり、同じフレームに同じ操作が
+	 *          重なった場合は1つにまとめる。取り出されなかった入力は次の poll() で捨てる。
+	 */
+	class InputQueue
+	{
+	public:
+
+		static constexpr size_t CAPACITY = 16;
+
+		explicit InputQueue();
+		virtual ~InputQueue();
+
+		// 前のフレームの残りを捨てて、このフレームで押された入力を積む
+		void poll();
+
+		// 画面のボタンなど、ほかから入った操作を積む
+		void push(InputAction action);
+
+		// 積んだ順に取り出す（空なら false）
+		bool pop(InputEvent& event);
+
+		bool isEmpty() const;
+		void clear();
+
+		// 取り出した入力で動き始めたときに呼ぶ
+		void recordDelay(const InputEvent& event);
+		const InputDelayStats& getDelayStats() const;
+
+	private:
+
+		Array<InputEvent> m_events;
+		size_t m_readIndex;
+		uint8 m_pushedBits;		// このフレームで積んだ操作
+		InputDelayStats m_delayStats;
+	};
+}
+
+#endif // !BNSCUP_INPUTQUEUE_H_
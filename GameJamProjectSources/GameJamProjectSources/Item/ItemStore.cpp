@@ -0,0 +1,102 @@
+﻿#include "ItemStore.h"
+#include "../Common/Common.h"
+#include "../Sprite/SpriteDrawList.h"
+
+namespace bnscup
+{
+	ItemStore::ItemStore()
+		: m_types{}
+		, m_positions{}
+		, m_srcRects{}
+		, m_textureIds{}
+		, m_colors{}
+		, m_owners{}
+		, m_textureNames{}
+		, m_textures{}
+	{
+	}
+
+	ItemStore::~ItemStore()
+	{
+	}
+
+	void ItemStore::reserve(size_t count)
+	{
+		m_types.reserve(count);
+		m_positions.reserve(count);
+		m_srcRects.reserve(count);
+		m_textureIds.reserve(count);
+		m_colors.reserve(count);
+		m_owners.reserve(count);
+	}
+
+	size_t ItemStore::add(Type type, const Vec2& pos, AssetNameView textureName, const RectF& srcRect, const ColorF& color)
+	{
+		m_types.push_back(type);
+		m_positions.push_back(pos);
+		m_srcRects.push_back(srcRect);
+		m_textureIds.push_back(findTexture(textureName));
+		m_colors.push_back(color);
+		m_owners.emplace_back();
+		return (m_types.size() - 1);
+	}
+
+	size_t ItemStore::getCount() const
+	{
+		return m_types.size();
+	}
+
+	void ItemStore::addSprites(SpriteDrawList& drawList) const
+	{
+		for (size_t i = 0; i < m_types.size(); ++i)
+		{
+			if (m_owners[i].isValid())
+			{
+				continue;
+			}
+			// 床に置いてあるので、位置（絵の中心）をそのまま足元とする
+			const RectF& srcRect = m_srcRects[i];
+			const Vec2 pos = m_positions[i] - Vec2{ srcRect.w * 0.5, srcRect.h * 0.5 };
+			drawList.add(&m_textures[m_textureIds[i]], srcRect, pos, m_positions[i].y, false, m_colors[i]);
+		}
+	}
+
+	ItemStore::Type ItemStore::getType(size_t itemIndex) const
+	{
+		return m_types[itemIndex];
+	}
+
+	const Vec2& ItemStore::getPos(size_t itemIndex) const
+	{
+		return m_positions[itemIndex];
+	}
+
+	void ItemStore::setOwner(size_t itemIndex, const UnitHandle& owner)
+	{
+		m_owners[itemIndex] = owner;
+	}
+
+	const UnitHandle& ItemStore::getOwner(size_t itemIndex) const
+	{
+		return m_owners[itemIndex];
+	}
+
+	bool ItemStore::existOwner(size_t itemIndex) const
+	{
+		return m_owners[itemIndex].isValid();
+	}
+
+	uint16 ItemStore::findTexture(AssetNameView textureName)
+	{
+		for (size_t i = 0; i < m_textureNames.size(); ++i)
+		{
+			if (m_textureNames[i] == textureName)
+			{
+				return static_cast<uint16>(i);
+			}
+		}
+		m_textureNames.emplace_back(textureName);
+		m_textures.push_back(TextureAsset(textureName));
+		return static_cast<uint16>(m_textures.size() - 1);
+	}
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+#ifndef BNSCUP_ITEMSTORE_H_
+#define BNSCUP_ITEMSTORE_H_
+
+#include <Siv3D.hpp>
+#include "../Unit/UnitStore.h"
+#include "../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	class SpriteDrawList;
+
+	/**
+	 * @brief マップ上のアイテムをまとめて持つ入れ物
+	 * @details アイテムは途中で消えないので、追加した順の番号をそのままハンドルとして使う。
+	 *          持ち主はユニットのハンドルで持ち、持ち主がいるアイテムは描画しない。
+	 */
+	class ItemStore
+	{
+	public:
+
+		enum class Type : uint8
+		{
+			GoldKey,
+			SilverKey,
+			CopperKey,
+		};
+
+	public:
+
+		explicit ItemStore();
+		virtual ~ItemStore();
+
+		void reserve(size_t count);
+
+		size_t add(Type type, const Vec2& pos, AssetNameView textureName, const RectF& srcRect, const ColorF& color = Palette::White);
+		size_t getCount() const;
+
+		// 持ち主のいないアイテムを描画する一覧に積む
+		void addSprites(SpriteDrawList& drawList) const;
+
+		Type getType(size_t itemIndex) const;
+		const Vec2& getPos(size_t itemIndex) const;
+
+		void setOwner(size_t itemIndex, const UnitHandle& owner);
+		const UnitHandle& getOwner(size_t itemIndex) const;
+		bool existOwner(size_t itemIndex) const;
+
+	private:
+
+		uint16 findTexture(AssetNameView textureName);
+
+	private:
+
+		SceneArray<Type> m_types;
+		SceneArray<Vec2> m_positions;
+		SceneArray<RectF> m_srcRects;
+		SceneArray<uint16> m_textureIds;
+		SceneArray<ColorF> m_colors;
+		SceneArray<UnitHandle> m_owners;
+
+		SceneArray<AssetName> m_textureNames;
+		SceneArray<Texture> m_textures;
+	};
+}
+
+#endif // !BNSCUP_ITEMSTORE_H_
@@ -1,5 +1,6 @@
 ﻿# include <Siv3D.hpp> // Siv3D v0.6.12
 # include "Common/Common.h"
+# include "Common/FixedTimestep.h"
 
 # ifdef _DEBUG
 # include "DebugPlayer/DebugPlayer.h"
@@ -17,7 +18,12 @@ namespace
 # include "Scene/Game/GameScene.h"
 # include "Scene/Exit/ExitScene.h"
 # include "AssetRegister/AssetRegister.h"
+# include "Button/Button.h"
+# include "Sound/SoundManager.h"
+# include "Memory/SceneArena.h"
 # include "Scene/Game/Map/MapData.h"
+# include "Scene/Game/Simulation/Replay.h"
+# include "Scene/Game/Simulation/StageData.h"
 
 namespace
 {
@@ -68,6 +74,7 @@ void Main()
 				TextureAsset::Load(info);
 			}
 		}
+		bnscup::Button::RegisterSounds();
 	}
 
 	// シーン用アセット登録インスタンス
@@ -76,13 +83,67 @@ void Main()
 		pAssetRegister.reset(new bnscup::AssetRegister());
 	}
 
+	// シーン中だけ使うオブジェクトの置き場（シーンをまたいで使い回す）
+	std::unique_ptr<bnscup::SceneArena> pSceneArena;
+	{
+		pSceneArena.reset(new bnscup::SceneArena(bnscup::SCENE_ARENA_BLOCK_SIZE));
+	}
+
+	// 時間で動くものは決まった長さのステップで進める
+	bnscup::FixedTimestep timestep{ bnscup::FIXED_STEP_TIME, bnscup::MAX_FIXED_STEP_COUNT };
+
+	// リプレイ再生の指定
+	// --replay <path> [--replay-speed <倍率>] [--replay-skip]
+	std::unique_ptr<bnscup::ReplayPlayback> pReplayPlayback;
+	{
+		const auto& args = System::GetCommandLineArgs();
+		for (size_t i : step(args.size()))
+		{
+			if (args[i] == U"--replay" and (i + 1) < args.size())
+			{
+				auto* pPlayback = new bnscup::ReplayPlayback{ bnscup::Replay{}, 1.0, false };
+				pReplayPlayback.reset(pPlayback);
+				// 読めないもの、このビルドに無いステージのものは再生しない
+				if (not(pReplayPlayback->replay.load(args[i + 1]))
+					or not(InRange(pReplayPlayback->replay.getStageNo(), 0, bnscup::GetStageCount() - 1)))
+				{
+					pReplayPlayback.reset();
+					break;
+				}
+			}
+		}
+		if (pReplayPlayback)
+		{
+			for (size_t i : step(args.size()))
+			{
+				if (args[i] == U"--replay-speed" and (i + 1) < args.size())
+				{
+					pReplayPlayback->speed = Max(ParseOr<double>(args[i + 1], 1.0), 0.01);
+				}
+				else if (args[i] == U"--replay-skip")
+				{
+					pReplayPlayback->isSkipAnim = true;
+				}
+			}
+		}
+	}
+
 	// シーン共通データ
 	std::shared_ptr<bnscup::SceneData> pSceneData;
 	{
 		pSceneData.reset(new bnscup::SceneData());
 		pSceneData->stageNo = -1;
 		pSceneData->pAssetRegister = pAssetRegister.get();
+		pSceneData->pSceneArena = pSceneArena.get();
+		pSceneData->pTimestep = &timestep;
 		pSceneData->nextScene = bnscup::SceneKey::Title;
+		pSceneData->pReplayPlayback = pReplayPlayback.get();
+		if (pReplayPlayback)
+		{
+			// リプレイのステージから直接始める
+			pSceneData->stageNo = pReplayPlayback->replay.getStageNo();
+			pSceneData->nextScene = bnscup::SceneKey::Game;
+		}
 	}
 
 	// ゲームシーンの登録
@@ -103,6 +164,7 @@ void Main()
 
 		if (not(g_debugPlayer.isPause()))
 		{
+			timestep.advance(Scene::DeltaTime());
 			if (not(gameApp.updateScene()))
 			{
 				// error
@@ -113,6 +175,7 @@ void Main()
 
 #else //_DEBUG
 
+		timestep.advance(Scene::DeltaTime());
 		if (not(gameApp.update()))
 		{
 			// error
@@ -120,5 +183,9 @@ void Main()
 		}
 
 #endif //_DEBUG
+
+		// フレーム中に溜まったボタンの音をまとめて鳴らす
+		bnscup::Button::FlushSounds();
+		bnscup::SoundManager::Update(Scene::DeltaTime());
 	}
 }
@@ -0,0 +1,50 @@
+﻿#pragma once
+#ifndef BNSCUP_ALLOCATIONSTATS_H_
+#define BNSCUP_ALLOCATIONSTATS_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief アリーナの確保回数
+	 * @details 数えるのはアリーナのブロックの確保だけ。SceneArray はブロックから切り出すので、足りている間は増えない。
+	 *          普通の Array や String など一般ヒープの確保は HeapCounter で数える。
+	 */
+	struct AllocationStats
+	{
+		size_t blockAllocCount = 0;	// ブロックを確保した回数
+		size_t blockAllocBytes = 0;	// ブロックを確保した合計サイズ
+		size_t acquireCount = 0;	// オブジェクトを取り出した回数
+		size_t releaseCount = 0;	// オブジェクトを返した回数
+		size_t inUseCount = 0;		// 今使っている数
+		size_t peakInUseCount = 0;	// 同時に使った最大数
+
+		void onBlockAlloc(size_t bytes)
+		{
+			blockAllocCount++;
+			blockAllocBytes += bytes;
+		}
+
+		void onAcquire()
+		{
+			acquireCount++;
+			inUseCount++;
+			peakInUseCount = Max(peakInUseCount, inUseCount);
+		}
+
+		void onRelease()
+		{
+			releaseCount++;
+			inUseCount--;
+		}
+
+		String format() const
+		{
+			return U"block {} ({} bytes), acquire {}, release {}, in use {}, peak {}"_fmt(
+				blockAllocCount, blockAllocBytes, acquireCount, releaseCount, inUseCount, peakInUseCount);
+		}
+	};
+}
+
+#endif // !BNSCUP_ALLOCATIONSTATS_H_
@@ -0,0 +1,85 @@
+﻿#include "HeapCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bnscup
+{
+	namespace
+	{
+		std::atomic<size_t> g_allocCount{ 0 };
+		std::atomic<size_t> g_allocBytes{ 0 };
+	}
+
+	size_t HeapCounter::GetAllocCount()
+	{
+		return g_allocCount.load(std::memory_order_relaxed);
+	}
+
+	size_t HeapCounter::GetAllocBytes()
+	{
+		return g_allocBytes.load(std::memory_order_relaxed);
+	}
+
+#ifdef _DEBUG
+	namespace
+	{
+		void* CountedAlloc(size_t size, size_t alignment)
+		{
+			g_allocCount.fetch_add(1, std::memory_order_relaxed);
+			g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+			size = Max<size_t>(size, 1);
+			if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			{
+				return std::malloc(size);
+			}
+			return _aligned_malloc(size, alignment);
+		}
+
+		void CountedFree(void* pData, size_t alignment)
+		{
+			if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			{
+				std::free(pData);
+				return;
+			}
+			_aligned_free(pData);
+		}
+
+		void* CountedNew(size_t size, size_t alignment)
+		{
+			void* pData = CountedAlloc(size, alignment);
+			if (pData == nullptr)
+			{
+				throw std::bad_alloc{};
+			}
+			return pData;
+		}
+	}
+#endif // _DEBUG
+}
+
+#ifdef _DEBUG
+// 置き換えはグローバル名前空間に置く必要がある
+void* operator new(std::size_t size) { return bnscup::CountedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size) { return bnscup::CountedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return bnscup::CountedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return bnscup::CountedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return bnscup::CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return bnscup::CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return bnscup::CountedAlloc(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return bnscup::CountedAlloc(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* pData) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pData) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pData, std::size_t) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pData, std::size_t) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pData, std::align_val_t alignment) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pData, std::align_val_t alignment) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+void operator delete(void* pData, std::size_t, std::align_val_t alignment) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pData, std::size_t, std::align_val_t alignment) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+void operator delete(void* pData, const std::nothrow_t&) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pData, const std::nothrow_t&) noexcept { bnscup::CountedFree(pData, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pData, std::align_val_t alignment, const std::nothrow_t&) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pData, std::align_val_t alignment, const std::nothrow_t&) noexcept { bnscup::CountedFree(pData, static_cast<std::size_t>(alignment)); }
+#endif // _DEBUG
@@ -0,0 +1,24 @@
+﻿#pragma once
+#ifndef BNSCUP_HEAPCOUNTER_H_
+#define BNSCUP_HEAPCOUNTER_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief 一般ヒープ（グローバルの operator new）を通った確保の回数
+	 * @details デバッグビルドだけ operator new を置き換えて数える。リリースビルドでは常に 0。
+	 *          シーンの生成や破棄の前後で差を取り、アリーナに乗っていない確保が残っていないかを確かめる。
+	 *          Siv3D の中で operator new を通らずに確保するもの（テクスチャの領域など）は数えない。
+	 */
+	class HeapCounter
+	{
+	public:
+
+		static size_t GetAllocCount();
+		static size_t GetAllocBytes();
+	};
+}
+
+#endif // !BNSCUP_HEAPCOUNTER_H_
@@ -0,0 +1,79 @@
+﻿#pragma once
+#ifndef BNSCUP_SCENEALLOCATOR_H_
+#define BNSCUP_SCENEALLOCATOR_H_
+
+#include <Siv3D.hpp>
+#include "SceneArena.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 作られたときに SceneArena::Scope の中なら、そのアリーナから確保するアロケーター
+	 * @details アリーナから確保した分は解放しても何もせず、アリーナを巻き戻すまで残す（伸ばした配列の古い領域も残る）。
+	 *          Scope の外で作られた場合は一般ヒープを使う。アリーナは巻き戻されるので、シーンより長く持つ配列には使わないこと。
+	 *          GetCurrent() を見るのでメインスレッドで作ること。
+	 */
+	template <class Type>
+	class SceneAllocator
+	{
+	public:
+
+		using value_type = Type;
+		using is_always_equal = std::false_type;
+
+		SceneAllocator() noexcept
+			: m_pArena{ SceneArena::GetCurrent() }
+		{
+		}
+
+		template <class Other>
+		SceneAllocator(const SceneAllocator<Other>& other) noexcept
+			: m_pArena{ other.getArena() }
+		{
+		}
+
+		Type* allocate(size_t count)
+		{
+			if (m_pArena == nullptr)
+			{
+				return std::allocator<Type>{}.allocate(count);
+			}
+			return static_cast<Type*>(m_pArena->allocate(sizeof(Type) * count, alignof(Type)));
+		}
+
+		void deallocate(Type* pData, size_t count) noexcept
+		{
+			if (m_pArena == nullptr)
+			{
+				std::allocator<Type>{}.deallocate(pData, count);
+			}
+		}
+
+		SceneArena* getArena() const noexcept
+		{
+			return m_pArena;
+		}
+
+		template <class Other>
+		bool operator==(const SceneAllocator<Other>& other) const noexcept
+		{
+			return (m_pArena == other.getArena());
+		}
+
+		template <class Other>
+		bool operator!=(const SceneAllocator<Other>& other) const noexcept
+		{
+			return (m_pArena != other.getArena());
+		}
+
+	private:
+
+		SceneArena* m_pArena;
+	};
+
+	// シーンの間だけ使う配列（シーンのアリーナに乗る）
+	template <class Type>
+	using SceneArray = Array<Type, SceneAllocator<Type>>;
+}
+
+#endif // !BNSCUP_SCENEALLOCATOR_H_
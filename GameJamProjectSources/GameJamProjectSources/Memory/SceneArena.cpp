@@ -0,0 +1,109 @@
+﻿#include "SceneArena.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		SceneArena* g_pCurrentArena = nullptr;
+	}
+
+	SceneArena::Scope::Scope(SceneArena* pArena)
+		: m_pArena{ pArena }
+		, m_pPrevArena{ g_pCurrentArena }
+	{
+		g_pCurrentArena = pArena;
+	}
+
+	SceneArena::Scope::~Scope()
+	{
+		g_pCurrentArena = m_pPrevArena;
+		if (m_pArena)
+		{
+			m_pArena->rewind();
+		}
+	}
+
+	SceneArena* SceneArena::Scope::getArena() const
+	{
+		return m_pArena;
+	}
+
+	//==================================================
+
+	SceneArena::SceneArena(size_t blockSize)
+		: m_blocks{}
+		, m_blockIndex{ 0 }
+		, m_offset{ 0 }
+		, m_blockSize{ blockSize }
+		, m_stats{}
+	{
+		// ブロックの一覧は最初に確保しておき、途中で伸ばさない
+		m_blocks.reserve(16);
+	}
+
+	SceneArena::~SceneArena()
+	{
+		DEBUG_BREAK(m_stats.inUseCount != 0);
+	}
+
+	void* SceneArena::allocate(size_t size, size_t alignment)
+	{
+		while (m_blockIndex < m_blocks.size())
+		{
+			auto& block = m_blocks[m_blockIndex];
+			const uintptr_t base = reinterpret_cast<uintptr_t>(block.pData.get());
+			const uintptr_t aligned = (base + m_offset + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+			const size_t begin = static_cast<size_t>(aligned - base);
+			if (begin + size <= block.size)
+			{
+				m_offset = begin + size;
+				return block.pData.get() + begin;
+			}
+			// 次のブロックへ（残りは巻き戻すまで使わない）
+			m_blockIndex++;
+			m_offset = 0;
+		}
+
+		// 足りないときだけ新しいブロックを一般ヒープから確保する
+		const size_t blockSize = Max(m_blockSize, size + alignment);
+		m_blocks.push_back(Block{ std::make_unique<std::byte[]>(blockSize), blockSize });
+		m_stats.onBlockAlloc(blockSize);
+		m_blockIndex = m_blocks.size() - 1;
+		m_offset = 0;
+		return allocate(size, alignment);
+	}
+
+	void SceneArena::rewind()
+	{
+		// 生きているオブジェクトの上に次のオブジェクトを置いてしまう
+		DEBUG_BREAK(m_stats.inUseCount != 0);
+		m_blockIndex = 0;
+		m_offset = 0;
+	}
+
+	size_t SceneArena::getUsedBytes() const
+	{
+		size_t usedBytes = m_offset;
+		for (size_t i = 0; i < m_blockIndex and i < m_blocks.size(); ++i)
+		{
+			usedBytes += m_blocks[i].size;
+		}
+		return usedBytes;
+	}
+
+	const AllocationStats& SceneArena::getStats() const
+	{
+		return m_stats;
+	}
+
+	SceneArena* SceneArena::GetCurrent()
+	{
+		return g_pCurrentArena;
+	}
+
+	void SceneArena::onDestroy()
+	{
+		m_stats.onRelease();
+	}
+}
@@ -0,0 +1,123 @@
+﻿#pragma once
+#ifndef BNSCUP_SCENEARENA_H_
+#define BNSCUP_SCENEARENA_H_
+
+#include <Siv3D.hpp>
+#include "AllocationStats.h"
+
+namespace bnscup
+{
+	class SceneArena;
+
+	/**
+	 * @brief アリーナ上のオブジェクトを破棄する（メモリはアリーナが巻き戻すまで残す）
+	 */
+	struct ArenaDeleter
+	{
+		SceneArena* pArena = nullptr;
+
+		template <class Type>
+		void operator()(Type* pObject) const;
+	};
+
+	template <class Type>
+	using ArenaPtr = std::unique_ptr<Type, ArenaDeleter>;
+
+	/**
+	 * @brief シーンの間だけ使うオブジェクトを詰めて置く領域
+	 * @details アプリの起動中ずっと同じものを使い、シーンを抜けるときに先頭まで巻き戻す。
+	 *          確保したブロックは巻き戻しても手放さないので、2回目以降のシーンでは新しいブロックを確保しない。
+	 *          オブジェクトが中で持つ配列は SceneArray（SceneAllocator.h）にしたものだけがアリーナに乗り、
+	 *          普通の Array や String、テクスチャなどは一般ヒープから確保する。
+	 */
+	class SceneArena
+	{
+	public:
+
+		/**
+		 * @brief 寿命のあいだアリーナを使い、抜けるときに巻き戻す
+		 * @details シーンのメンバーの先頭に置けば、ほかのメンバーがすべて破棄されたあとに巻き戻る。
+		 *          寿命のあいだは GetCurrent() がこのアリーナを返す（nullptr を渡すと一般ヒープに戻す）。
+		 */
+		class Scope
+		{
+		public:
+
+			explicit Scope(SceneArena* pArena);
+			virtual ~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			SceneArena* getArena() const;
+
+		private:
+
+			SceneArena* m_pArena;
+			SceneArena* m_pPrevArena;
+		};
+
+	public:
+
+		explicit SceneArena(size_t blockSize);
+		virtual ~SceneArena();
+
+		SceneArena(const SceneArena&) = delete;
+		SceneArena& operator=(const SceneArena&) = delete;
+
+		template <class Type, class... Args>
+		ArenaPtr<Type> create(Args&&... args)
+		{
+			void* pMemory = allocate(sizeof(Type), alignof(Type));
+			Type* pObject = new (pMemory) Type(std::forward<Args>(args)...);
+			m_stats.onAcquire();
+			return ArenaPtr<Type>{ pObject, ArenaDeleter{ this } };
+		}
+
+		void* allocate(size_t size, size_t alignment);
+
+		// 生きているオブジェクトが無いときだけ呼ぶこと
+		void rewind();
+
+		size_t getUsedBytes() const;
+		const AllocationStats& getStats() const;
+
+		// 今いる Scope のアリーナ（無ければ nullptr）
+		static SceneArena* GetCurrent();
+
+	private:
+
+		friend struct ArenaDeleter;
+		void onDestroy();
+
+	private:
+
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> pData;
+			size_t size;
+		};
+
+		Array<Block> m_blocks;
+		size_t m_blockIndex;
+		size_t m_offset;
+		size_t m_blockSize;
+		AllocationStats m_stats;
+	};
+
+	template <class Type>
+	void ArenaDeleter::operator()(Type* pObject) const
+	{
+		if (pObject == nullptr)
+		{
+			return;
+		}
+		pObject->~Type();
+		if (pArena)
+		{
+			pArena->onDestroy();
+		}
+	}
+}
+
+#endif // !BNSCUP_SCENEARENA_H_
@@ -1,5 +1,4 @@
 ﻿#include "MessageBox.h"
-#include "../Button/Button.h"
 
 namespace bnscup
 {
@@ -12,36 +11,35 @@ namespace bnscup
 		, m_bodyMessage{ bodyMessage }
 		, m_positiveText{}
 		, m_negativeText{}
-		, m_pPositiveButton{ nullptr }
-		, m_pNegativeButton{ nullptr }
-		, m_pExitCrossButton{ nullptr }
+		, m_bodyLayout{}
+		, m_pPositiveLayout{ nullptr }
+		, m_pNegativeLayout{ nullptr }
+		, m_positiveButton{ none }
+		, m_negativeButton{ none }
+		, m_exitCrossButton{ none }
 	{
 		m_crossTexture = TextureAsset(U"icon_cross");
 		switch (m_buttonStyle)
 		{
 		case ButtonStyle::OKCancel:
 		{
-			auto* pNegativeButton = new Button(RectF::Empty());
-			m_negativeText = U"CANCEL";
-			m_pNegativeButton.reset(pNegativeButton);
+			m_negativeButton.emplace(RectF::Empty());
+			m_negativeText = TextTable::Get(TextId::MessageCancel);
 		}
 		[[fallthrough]];
 		case ButtonStyle::OnlyOK:
 		{
-			auto* pPositiveButton = new Button(RectF::Empty());
-			m_positiveText = U"OK";
-			m_pPositiveButton.reset(pPositiveButton);
+			m_positiveButton.emplace(RectF::Empty());
+			m_positiveText = TextTable::Get(TextId::MessageOK);
 			break;
 		}
 		case ButtonStyle::YesNo:
 		{
-			auto* pNegativeButton = new Button(RectF::Empty());
-			m_negativeText = U"いいえ";
-			m_pNegativeButton.reset(pNegativeButton);
+			m_negativeButton.emplace(RectF::Empty());
+			m_negativeText = TextTable::Get(TextId::MessageNo);
 
-			auto* pPositiveButton = new Button(RectF::Empty());
-			m_positiveText = U"はい";
-			m_pPositiveButton.reset(pPositiveButton);
+			m_positiveButton.emplace(RectF::Empty());
+			m_positiveText = TextTable::Get(TextId::MessageYes);
 			break;
 		}
 		default:
@@ -49,8 +47,7 @@ namespace bnscup
 		}
 		if (existCross)
 		{
-			auto* pCrossButton = new Button(RectF::Empty());
-			m_pExitCrossButton.reset(pCrossButton);
+			m_exitCrossButton.emplace(RectF::Empty());
 		}
 	}
 
@@ -58,24 +55,29 @@ namespace bnscup
 	{
 	}
 
-	void MessageBox::update()
+	void MessageBox::prepare()
 	{
 		if (m_bodyRect.isEmpty())
 		{
 			calcRegion();
 		}
+	}
 
-		if (m_pPositiveButton)
+	void MessageBox::update()
+	{
+		prepare();
+
+		if (m_positiveButton)
 		{
-			m_pPositiveButton->update();
+			m_positiveButton->update();
 		}
-		if (m_pNegativeButton)
+		if (m_negativeButton)
 		{
-			m_pNegativeButton->update();
+			m_negativeButton->update();
 		}
-		if (m_pExitCrossButton)
+		if (m_exitCrossButton)
 		{
-			m_pExitCrossButton->update();
+			m_exitCrossButton->update();
 		}
 	}
 
@@ -89,22 +91,28 @@ namespace bnscup
 		const double margin = 10.0;
 		m_bodyRect.rounded(margin * 0.5).draw(Palette::Darkgreen).drawFrame();
 		m_messageRect.rounded(margin * 0.5).draw(Palette::Whitesmoke);
-		(*m_spFont)(m_bodyMessage).drawAt(m_messageRect.center(), Palette::Black);
-		if (m_pPositiveButton)
+		m_bodyLayout.drawAt(m_messageRect.center(), Palette::Black);
+		if (m_positiveButton)
 		{
-			const auto& buttonRect = m_pPositiveButton->getRect();
+			const auto& buttonRect = m_positiveButton->getRect();
 			buttonRect.rounded(margin * 0.5).draw(Palette::Midnightblue).drawFrame();
-			(*m_spFont)(m_positiveText).drawAt(buttonRect.center(), Palette::Black);
+			if (m_pPositiveLayout)
+			{
+				m_pPositiveLayout->drawAt(buttonRect.center(), Palette::Black);
+			}
 		}
-		if (m_pNegativeButton)
+		if (m_negativeButton)
 		{
-			const auto& buttonRect = m_pNegativeButton->getRect();
+			const auto& buttonRect = m_negativeButton->getRect();
 			buttonRect.rounded(margin * 0.5).draw(Palette::Whitesmoke).drawFrame();
-			(*m_spFont)(m_negativeText).drawAt(buttonRect.center(), Palette::Black);
+			if (m_pNegativeLayout)
+			{
+				m_pNegativeLayout->drawAt(buttonRect.center(), Palette::Black);
+			}
 		}
-		if (m_pExitCrossButton)
+		if (m_exitCrossButton)
 		{
-			const auto& buttonRect = m_pExitCrossButton->getRect();
+			const auto& buttonRect = m_exitCrossButton->getRect();
 			buttonRect.rounded(margin * 0.5).draw(Palette::Darkred).drawFrame();
 			m_crossTexture.drawAt(buttonRect.center());
 		}
@@ -117,20 +125,20 @@ namespace bnscup
 
 	bool MessageBox::isPositiveSelected() const
 	{
-		if (m_pPositiveButton.get() == nullptr)
+		if (not(m_positiveButton.has_value()))
 		{
 			return false;
 		}
-		return m_pPositiveButton->isSelected(Button::Sounds::OK);
+		return m_positiveButton->isSelected(Button::Sounds::OK);
 	}
 
 	bool MessageBox::isNegativeSelected() const
 	{
-		if (m_pNegativeButton.get() == nullptr)
+		if (not(m_negativeButton.has_value()))
 		{
 			return false;
 		}
-		return m_pNegativeButton->isSelected(Button::Sounds::Cancel);
+		return m_negativeButton->isSelected(Button::Sounds::Cancel);
 	}
 
 	bool MessageBox::isOKSelected() const
@@ -155,11 +163,11 @@ namespace bnscup
 
 	bool MessageBox::isExitCrossSelected() const
 	{
-		if (m_pExitCrossButton.get() == nullptr)
+		if (not(m_exitCrossButton.has_value()))
 		{
 			return false;
 		}
-		return m_pExitCrossButton->isSelected(Button::Sounds::Cancel);
+		return m_exitCrossButton->isSelected(Button::Sounds::Cancel);
 	}
 
 	void MessageBox::calcRegion()
@@ -171,8 +179,19 @@ namespace bnscup
 
 		const double margin = 10.0;
 
-		m_bodyRect = (*m_spFont)(m_bodyMessage).region();
-		auto buttonRegion = (*m_spFont)(U"CANCEL").region();
+		// 文字の並びはここで一度だけ作って draw() で使い回す
+		m_bodyLayout.build(*m_spFont, m_bodyMessage);
+		if (m_positiveButton)
+		{
+			m_pPositiveLayout = TextLayoutCache::Get(*m_spFont, m_positiveText);
+		}
+		if (m_negativeButton)
+		{
+			m_pNegativeLayout = TextLayoutCache::Get(*m_spFont, m_negativeText);
+		}
+
+		m_bodyRect = m_bodyLayout.getRegion();
+		auto buttonRegion = TextLayoutCache::Get(*m_spFont, TextTable::Get(TextId::MessageCancel))->getRegion();
 		buttonRegion = buttonRegion.stretched(margin * 0.5, margin, margin * 0.5, margin);
 
 		double minWidth = buttonRegion.w * 2 + margin * 3;
@@ -183,9 +202,9 @@ namespace bnscup
 		m_bodyRect.setCenter(Scene::CenterF());
 
 		const double buttonPosY = m_bodyRect.bottomY() + margin;
-		if (m_pPositiveButton)
+		if (m_positiveButton)
 		{
-			auto& positiveRect = m_pPositiveButton->getRect();
+			auto& positiveRect = m_positiveButton->getRect();
 			positiveRect.set(buttonRegion);
 			switch (m_buttonStyle)
 			{
@@ -206,9 +225,9 @@ namespace bnscup
 			default: break;
 			}
 		}
-		if (m_pNegativeButton)
+		if (m_negativeButton)
 		{
-			auto& negativeRect = m_pNegativeButton->getRect();
+			auto& negativeRect = m_negativeButton->getRect();
 			negativeRect.set(buttonRegion);
 			switch (m_buttonStyle)
 			{
@@ -228,15 +247,15 @@ namespace bnscup
 		double bottomMargin = margin;
 		m_messageRect = m_bodyRect;
 		m_messageRect = m_messageRect.stretched(margin * 0.5);
-		if (m_pPositiveButton)
+		if (m_positiveButton)
 		{
-			bottomMargin += m_pPositiveButton->getRect().h + margin;
+			bottomMargin += m_positiveButton->getRect().h + margin;
 		}
 		m_bodyRect = m_bodyRect.stretched(margin, margin, bottomMargin, margin);
 
-		if (m_pExitCrossButton)
+		if (m_exitCrossButton)
 		{
-			auto& crossButton = m_pExitCrossButton->getRect();
+			auto& crossButton = m_exitCrossButton->getRect();
 			crossButton.setSize(30, 30);
 			crossButton.setPos(m_bodyRect.tr() - (Vec2{ crossButton.size.x - margin, margin }));
 		}
@@ -3,10 +3,12 @@
 #define BNSCUP_MESSAGEBOX_H_
 
 #include <Siv3D.hpp>
+#include "../Button/Button.h"
+#include "../Text/TextLayout.h"
+#include "../Text/TextTable.h"
 
 namespace bnscup
 {
-	class Button;
 	class MessageBox
 	{
 	public:
@@ -21,9 +23,13 @@ namespace bnscup
 
 		using ExistCrossButton = YesNo<struct ExistCrossButton_tag>;
 
+		// bodyMessage は TextTable の文字など、MessageBox より長く残るものを渡す（写さずに指すだけ）
 		explicit MessageBox(ButtonStyle btnStyle, ExistCrossButton existCross, StringView bodyMessage);
 		virtual ~MessageBox();
 
+		// 配置を決める（まだなら）。作り直さないので使い回せる
+		void prepare();
+
 		void update();
 		void draw() const;
 
@@ -49,12 +55,17 @@ namespace bnscup
 		RectF m_bodyRect;
 		RectF m_messageRect;
 		ButtonStyle m_buttonStyle;
-		String m_bodyMessage;
-		String m_positiveText;
-		String m_negativeText;
-		std::unique_ptr<Button> m_pPositiveButton;
-		std::unique_ptr<Button> m_pNegativeButton;
-		std::unique_ptr<Button> m_pExitCrossButton;
+		StringView m_bodyMessage;	// TextTable の文字を指すだけ
+		StringView m_positiveText;
+		StringView m_negativeText;
+		// 文字は calcRegion() で一度だけ並べる（ボタンの文字は共有する）
+		TextLayout m_bodyLayout;
+		const TextLayout* m_pPositiveLayout;
+		const TextLayout* m_pNegativeLayout;
+		// ボタンは別に確保せず中に持つ
+		Optional<Button> m_positiveButton;
+		Optional<Button> m_negativeButton;
+		Optional<Button> m_exitCrossButton;
 	};
 }
 
@@ -0,0 +1,163 @@
+﻿#include "PopupStack.h"
+#include "../Common/Common.h"
+#include "../Text/TextTable.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		struct PopupDesc
+		{
+			TextId textId;
+			MessageBox::ButtonStyle buttonStyle;
+		};
+
+		// PopupId の順
+		static const PopupDesc POPUP_TABLE[] =
+		{
+			{ TextId::PopupUseKey,				MessageBox::ButtonStyle::YesNo },
+			{ TextId::PopupRescue,				MessageBox::ButtonStyle::OnlyOK },
+			{ TextId::PopupReturnNotAllRescued,	MessageBox::ButtonStyle::YesNo },
+			{ TextId::PopupReturnAllRescued,	MessageBox::ButtonStyle::OnlyOK },
+			{ TextId::PopupNotHaveKey,			MessageBox::ButtonStyle::OnlyOK },
+			{ TextId::PopupCaught,				MessageBox::ButtonStyle::YesNo },
+		};
+		static_assert(std::size(POPUP_TABLE) == FromEnum(PopupId::Count));
+	}
+
+	PopupStack::PopupStack()
+		: m_boxes{}
+		, m_stack{}
+		, m_depth{ 0 }
+		, m_notices{}
+		, m_noticeHead{ 0 }
+		, m_noticeCount{ 0 }
+	{
+		// 全部先に作って配置も決めておく（ゲーム中は作らない）
+		for (size_t i : step(m_boxes.size()))
+		{
+			const auto& desc = POPUP_TABLE[i];
+			m_boxes[i].emplace(desc.buttonStyle, MessageBox::ExistCrossButton::No, TextTable::Get(desc.textId));
+			m_boxes[i]->prepare();
+		}
+	}
+
+	PopupStack::~PopupStack()
+	{
+	}
+
+	void PopupStack::push(PopupId id)
+	{
+		if (MAX_DEPTH <= m_depth)
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		for (size_t i : step(m_depth))
+		{
+			if (m_stack[i] == id)
+			{
+				// 同じ MessageBox を2か所には出せない
+				DEBUG_BREAK(true);
+				return;
+			}
+		}
+		m_stack[m_depth] = id;
+		++m_depth;
+	}
+
+	void PopupStack::pop()
+	{
+		if (m_depth == 0)
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		--m_depth;
+	}
+
+	MessageBox* PopupStack::getTop()
+	{
+		if (m_depth == 0)
+		{
+			return nullptr;
+		}
+		return &getBox(m_stack[m_depth - 1]);
+	}
+
+	bool PopupStack::isEmpty() const
+	{
+		return (m_depth == 0);
+	}
+
+	void PopupStack::pushNotice(PopupId id)
+	{
+		for (size_t i : step(m_noticeCount))
+		{
+			if (m_notices[(m_noticeHead + i) % MAX_NOTICE_COUNT] == id)
+			{
+				return;
+			}
+		}
+		if (MAX_NOTICE_COUNT <= m_noticeCount)
+		{
+			// 古いものを捨てて新しいものを出す
+			m_noticeHead = (m_noticeHead + 1) % MAX_NOTICE_COUNT;
+			--m_noticeCount;
+		}
+		m_notices[(m_noticeHead + m_noticeCount) % MAX_NOTICE_COUNT] = id;
+		++m_noticeCount;
+	}
+
+	void PopupStack::updateNotice()
+	{
+		if (m_depth != 0 or m_noticeCount == 0)
+		{
+			return;
+		}
+
+		auto& box = getBox(m_notices[m_noticeHead]);
+		box.update();
+		if (box.isOKSelected())
+		{
+			m_noticeHead = (m_noticeHead + 1) % MAX_NOTICE_COUNT;
+			--m_noticeCount;
+		}
+	}
+
+	void PopupStack::clear()
+	{
+		m_depth = 0;
+		m_noticeHead = 0;
+		m_noticeCount = 0;
+	}
+
+	void PopupStack::draw() const
+	{
+		// 答えを待つものがある間はお知らせを出さない
+		if (m_depth == 0)
+		{
+			if (m_noticeCount != 0)
+			{
+				getBox(m_notices[m_noticeHead]).draw();
+			}
+			return;
+		}
+
+		// 下から順に重ねる
+		for (size_t i : step(m_depth))
+		{
+			getBox(m_stack[i]).draw();
+		}
+	}
+
+	MessageBox& PopupStack::getBox(PopupId id)
+	{
+		return *m_boxes[FromEnum(id)];
+	}
+
+	const MessageBox& PopupStack::getBox(PopupId id) const
+	{
+		return *m_boxes[FromEnum(id)];
+	}
+}
@@ -0,0 +1,79 @@
+﻿#pragma once
+#ifndef BNSCUP_POPUPSTACK_H_
+#define BNSCUP_POPUPSTACK_H_
+
+#include <Siv3D.hpp>
+#include "MessageBox.h"
+
+namespace bnscup
+{
+	// ゲーム中に出すポップアップ（PopupStack.cpp の表と同じ順）
+	enum class PopupId : uint8
+	{
+		UseKey,
+		Rescue,
+		ReturnNotAllRescued,
+		ReturnAllRescued,
+		NotHaveKey,
+		Caught,
+
+		Count,
+	};
+
+	/**
+	 * @brief ゲーム中のポップアップをまとめて受け持つ
+	 * @details MessageBox はポップアップの種類ごとに最初に1つだけ作って配置も済ませておき、閉じても破棄せずに使い回す。
+	 *          答えを待つものは push() で積み、一番上だけが入力を受け取る（上を閉じると下に戻る）。
+	 *          お知らせだけのものは pushNotice() で順番待ちに並べ、答えを待つものが無い間に1つずつ出す。
+	 *          お知らせはゲームを止めず、OK で閉じると次のお知らせに進む。
+	 */
+	class PopupStack
+	{
+	public:
+
+		static constexpr size_t MAX_DEPTH = 4;			// 重ねられる数
+		static constexpr size_t MAX_NOTICE_COUNT = 8;	// 並べておけるお知らせの数
+
+	public:
+
+		explicit PopupStack();
+		virtual ~PopupStack();
+
+		PopupStack(const PopupStack&) = delete;
+		PopupStack& operator=(const PopupStack&) = delete;
+
+		// 答えを待つポップアップを上に積む
+		void push(PopupId id);
+		// 一番上を閉じる
+		void pop();
+		// 一番上（無ければ nullptr）。答えを調べる前に update() を呼ぶこと
+		MessageBox* getTop();
+		bool isEmpty() const;
+
+		// お知らせを並べる（同じものが並んでいれば並べない）
+		void pushNotice(PopupId id);
+		// 答えを待つものが無い間だけ、先頭のお知らせを進める
+		void updateNotice();
+
+		// すべて閉じる
+		void clear();
+
+		void draw() const;
+
+	private:
+
+		MessageBox& getBox(PopupId id);
+		const MessageBox& getBox(PopupId id) const;
+
+	private:
+
+		std::array<Optional<MessageBox>, FromEnum(PopupId::Count)> m_boxes;
+		std::array<PopupId, MAX_DEPTH> m_stack;
+		size_t m_depth;
+		std::array<PopupId, MAX_NOTICE_COUNT> m_notices;	// 先頭から順に出す（輪にして使う）
+		size_t m_noticeHead;
+		size_t m_noticeCount;
+	};
+}
+
+#endif // !BNSCUP_POPUPSTACK_H_
@@ -0,0 +1,35 @@
+﻿#include "ParticleEmitter.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// パックの登録は別スレッドから呼ばれる
+		std::mutex g_emitterMutex;
+		HashTable<AssetName, std::unique_ptr<ParticleEmitterDesc>> g_emitters;
+	}
+
+	void ParticleEmitterLibrary::Register(AssetNameView name, const ParticleEmitterDesc& desc)
+	{
+		std::lock_guard lock{ g_emitterMutex };
+		g_emitters[AssetName{ name }] = std::make_unique<ParticleEmitterDesc>(desc);
+	}
+
+	void ParticleEmitterLibrary::Unregister(AssetNameView name)
+	{
+		std::lock_guard lock{ g_emitterMutex };
+		g_emitters.erase(AssetName{ name });
+	}
+
+	const ParticleEmitterDesc* ParticleEmitterLibrary::Find(AssetNameView name)
+	{
+		std::lock_guard lock{ g_emitterMutex };
+		const auto it = g_emitters.find(AssetName{ name });
+		if (it == g_emitters.end())
+		{
+			return nullptr;
+		}
+		return it->second.get();
+	}
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+#ifndef BNSCUP_PARTICLEEMITTER_H_
+#define BNSCUP_PARTICLEEMITTER_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief 一度に出すパーティクルの出し方
+	 * @details アセットパックの "particleEmitterDatas" から読み込む。
+	 *          角度は度で、0 が右、90 が下（画面の座標と同じ向き）。
+	 */
+	struct ParticleEmitterDesc
+	{
+		int32 count = 16;			// 一度に出す数
+		double lifeMin = 0.5;		// 寿命（秒）
+		double lifeMax = 0.5;
+		double speedMin = 0.0;		// 初速（ピクセル/秒）
+		double speedMax = 0.0;
+		double angle = -90.0;		// 出す向きの中心
+		double spread = 360.0;		// 出す向きの広がり
+		double radius = 0.0;		// 出す位置のばらつき
+		double gravity = 0.0;		// 下向きの加速度（ピクセル/秒^2）
+		double drag = 0.0;			// 1秒あたりの減速の割合
+		double sizeStart = 2.0;		// 一辺の長さ
+		double sizeEnd = 0.0;
+		ColorF colorStart{ 1.0 };
+		ColorF colorEnd{ 1.0, 0.0 };
+		bool isAdditive = false;	// 加算合成で描くか
+	};
+
+	/**
+	 * @brief アセットパックから読み込んだパーティクルの出し方の置き場
+	 * @details AnimationClipLibrary と同じく名前で登録し、参照側は一度だけ引いてポインタを持つ。
+	 */
+	class ParticleEmitterLibrary
+	{
+	public:
+
+		static void Register(AssetNameView name, const ParticleEmitterDesc& desc);
+		static void Unregister(AssetNameView name);
+
+		// 見つからない場合は nullptr
+		static const ParticleEmitterDesc* Find(AssetNameView name);
+	};
+}
+
+#endif // !BNSCUP_PARTICLEEMITTER_H_
@@ -0,0 +1,183 @@
+﻿#include "ParticleSystem.h"
+#include "ParticleEmitter.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	ParticleSystem::ParticleSystem(size_t capacity)
+		: m_posX{}
+		, m_posY{}
+		, m_velX{}
+		, m_velY{}
+		, m_gravities{}
+		, m_drags{}
+		, m_ages{}
+		, m_ageRates{}
+		, m_emitterIds{}
+		, m_capacity{ capacity }
+		, m_count{ 0 }
+		, m_peakCount{ 0 }
+		, m_droppedCount{ 0 }
+		, m_emitters{}
+	{
+		// 途中で確保し直さないよう、上限の数だけ先に確保しておく
+		for (auto* pArray : { &m_posX, &m_posY, &m_velX, &m_velY, &m_gravities, &m_drags, &m_ages, &m_ageRates })
+		{
+			pArray->resize(capacity, 0.0f);
+		}
+		m_emitterIds.resize(capacity, 0);
+	}
+
+	ParticleSystem::~ParticleSystem()
+	{
+	}
+
+	uint16 ParticleSystem::addEmitter(AssetNameView emitterName)
+	{
+		const ParticleEmitterDesc* pDesc = ParticleEmitterLibrary::Find(emitterName);
+		DEBUG_BREAK(pDesc == nullptr); // パックに定義が無い
+		for (size_t i = 0; i < m_emitters.size(); ++i)
+		{
+			if (m_emitters[i] == pDesc)
+			{
+				return static_cast<uint16>(i);
+			}
+		}
+		m_emitters.push_back(pDesc);
+		return static_cast<uint16>(m_emitters.size() - 1);
+	}
+
+	void ParticleSystem::emit(uint16 emitterId, const Vec2& pos)
+	{
+		if (m_emitters.size() <= emitterId or m_emitters[emitterId] == nullptr)
+		{
+			return;
+		}
+		const auto& desc = *m_emitters[emitterId];
+		for (int32 n = 0; n < desc.count; ++n)
+		{
+			if (m_capacity <= m_count)
+			{
+				m_droppedCount += (desc.count - n);
+				break;
+			}
+			const size_t i = m_count++;
+
+			const double spawnAngle = Random(0.0, Math::TwoPi);
+			const double spawnDistance = Random(0.0, desc.radius);
+			const double angle = Math::ToRadians(desc.angle + Random(-0.5, 0.5) * desc.spread);
+			const double speed = Random(desc.speedMin, desc.speedMax);
+			const double life = Max(Random(desc.lifeMin, desc.lifeMax), 0.001);
+
+			m_posX[i] = static_cast<float>(pos.x + std::cos(spawnAngle) * spawnDistance);
+			m_posY[i] = static_cast<float>(pos.y + std::sin(spawnAngle) * spawnDistance);
+			m_velX[i] = static_cast<float>(std::cos(angle) * speed);
+			m_velY[i] = static_cast<float>(std::sin(angle) * speed);
+			m_gravities[i] = static_cast<float>(desc.gravity);
+			m_drags[i] = static_cast<float>(desc.drag);
+			m_ages[i] = 0.0f;
+			m_ageRates[i] = static_cast<float>(1.0 / life);
+			m_emitterIds[i] = emitterId;
+		}
+		m_peakCount = Max(m_peakCount, m_count);
+	}
+
+	void ParticleSystem::clear()
+	{
+		m_count = 0;
+	}
+
+	void ParticleSystem::update(double deltaTime)
+	{
+		if (m_count == 0)
+		{
+			return;
+		}
+
+		const float dt = static_cast<float>(deltaTime);
+		const size_t count = m_count;
+		float* const posX = m_posX.data();
+		float* const posY = m_posY.data();
+		float* const velX = m_velX.data();
+		float* const velY = m_velY.data();
+		const float* const gravities = m_gravities.data();
+		const float* const drags = m_drags.data();
+		float* const ages = m_ages.data();
+		const float* const ageRates = m_ageRates.data();
+
+		// 分岐のない単純なループにして、コンパイラがまとめて計算できるようにする
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float damping = std::max(1.0f - drags[i] * dt, 0.0f);
+			velX[i] = velX[i] * damping;
+			velY[i] = velY[i] * damping + gravities[i] * dt;
+			posX[i] += velX[i] * dt;
+			posY[i] += velY[i] * dt;
+			ages[i] += ageRates[i] * dt;
+		}
+
+		// 寿命の尽きたものは末尾と入れ替えて詰める（描く順は気にしない）
+		size_t i = 0;
+		while (i < m_count)
+		{
+			if (ages[i] < 1.0f)
+			{
+				++i;
+				continue;
+			}
+			const size_t last = --m_count;
+			posX[i] = posX[last];
+			posY[i] = posY[last];
+			velX[i] = velX[last];
+			velY[i] = velY[last];
+			m_gravities[i] = m_gravities[last];
+			m_drags[i] = m_drags[last];
+			ages[i] = ages[last];
+			m_ageRates[i] = m_ageRates[last];
+			m_emitterIds[i] = m_emitterIds[last];
+		}
+	}
+
+	void ParticleSystem::draw() const
+	{
+		if (m_count == 0)
+		{
+			return;
+		}
+		drawParticles(false);
+		{
+			const ScopedRenderStates2D blendState{ BlendState::Additive };
+			drawParticles(true);
+		}
+	}
+
+	size_t ParticleSystem::getCount() const
+	{
+		return m_count;
+	}
+
+	size_t ParticleSystem::getPeakCount() const
+	{
+		return m_peakCount;
+	}
+
+	size_t ParticleSystem::getDroppedCount() const
+	{
+		return m_droppedCount;
+	}
+
+	void ParticleSystem::drawParticles(bool isAdditive) const
+	{
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			const auto& desc = *m_emitters[m_emitterIds[i]];
+			if (desc.isAdditive != isAdditive)
+			{
+				continue;
+			}
+			const double t = m_ages[i];
+			const double size = Math::Lerp(desc.sizeStart, desc.sizeEnd, t);
+			RectF{ Arg::center(m_posX[i], m_posY[i]), size }.draw(desc.colorStart.lerp(desc.colorEnd, t));
+		}
+	}
+}
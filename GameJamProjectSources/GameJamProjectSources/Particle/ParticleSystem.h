@@ -0,0 +1,64 @@
+﻿#pragma once
+#ifndef BNSCUP_PARTICLESYSTEM_H_
+#define BNSCUP_PARTICLESYSTEM_H_
+
+#include <Siv3D.hpp>
+#include "../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	struct ParticleEmitterDesc;
+
+	/**
+	 * @brief テクスチャを使わない小さな四角のパーティクルをまとめて動かす入れ物
+	 * @details 位置や速度を項目ごとの float 配列で持ち、更新は分岐のないループを流すだけにする。
+	 *          配列は作るときに上限の数だけ確保し、上限を超えて出そうとした分は捨てる。
+	 *          色と大きさは出し方（ParticleEmitterDesc）と経過の割合から描画時に求める。
+	 */
+	class ParticleSystem
+	{
+	public:
+
+		explicit ParticleSystem(size_t capacity);
+		virtual ~ParticleSystem();
+
+		// 出し方を名前から引いて番号を返す（同じ出し方は同じ番号）
+		uint16 addEmitter(AssetNameView emitterName);
+
+		void emit(uint16 emitterId, const Vec2& pos);
+		void clear();
+
+		void update(double deltaTime);
+		void draw() const;
+
+		size_t getCount() const;
+		size_t getPeakCount() const;
+		size_t getDroppedCount() const;
+
+	private:
+
+		void drawParticles(bool isAdditive) const;
+
+	private:
+
+		// パーティクルごとの項目（先頭から m_count 個が生きている）
+		SceneArray<float> m_posX;
+		SceneArray<float> m_posY;
+		SceneArray<float> m_velX;
+		SceneArray<float> m_velY;
+		SceneArray<float> m_gravities;
+		SceneArray<float> m_drags;
+		SceneArray<float> m_ages;		// 経過の割合（1.0 で消える）
+		SceneArray<float> m_ageRates;	// 1秒あたりに進む割合（寿命の逆数）
+		SceneArray<uint16> m_emitterIds;
+
+		size_t m_capacity;
+		size_t m_count;
+		size_t m_peakCount;
+		size_t m_droppedCount;
+
+		SceneArray<const ParticleEmitterDesc*> m_emitters;
+	};
+}
+
+#endif // !BNSCUP_PARTICLESYSTEM_H_
@@ -0,0 +1,62 @@
+﻿#include "RetainedLayer.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// 透明なテクスチャに重ねて描くので、色は乗算済みで、透明度は普通に重ねて残す
+		static const BlendState MakeLayerBlendState()
+		{
+			BlendState blendState = BlendState::Default2D;
+			blendState.srcAlpha = Blend::One;
+			blendState.dstAlpha = Blend::InvSrcAlpha;
+			blendState.opAlpha = BlendOp::Add;
+			return blendState;
+		}
+	}
+
+	RetainedLayer::RetainedLayer(const Rect& region)
+		: m_region{ region }
+		, m_renderTexture{ static_cast<uint32>(region.w), static_cast<uint32>(region.h) }
+		, m_isDirty{ true }
+		, m_refreshCount{ 0 }
+	{
+	}
+
+	RetainedLayer::~RetainedLayer()
+	{
+	}
+
+	void RetainedLayer::markDirty()
+	{
+		m_isDirty = true;
+	}
+
+	bool RetainedLayer::isDirty() const
+	{
+		return m_isDirty;
+	}
+
+	void RetainedLayer::draw() const
+	{
+		// 中身は乗算済みの色なのでそのまま重ねる
+		const ScopedRenderStates2D blend{ BlendState::Premultiplied };
+		m_renderTexture.draw(m_region.pos);
+	}
+
+	const Rect& RetainedLayer::getRegion() const
+	{
+		return m_region;
+	}
+
+	size_t RetainedLayer::getRefreshCount() const
+	{
+		return m_refreshCount;
+	}
+
+	const BlendState& RetainedLayer::GetRefreshBlendState()
+	{
+		static const BlendState blendState = MakeLayerBlendState();
+		return blendState;
+	}
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#ifndef BNSCUP_RETAINEDLAYER_H_
+#define BNSCUP_RETAINEDLAYER_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief 変わらない画面の一部をテクスチャに描いておき、毎フレームはそれを1枚貼るだけにする
+	 * @details 中身が変わったら markDirty() し、refresh() に渡した関数で描き直す。
+	 *          汚れていなければ refresh() は何もしないので、止まっている画面はテクスチャ1枚分の描画で済む。
+	 *          refresh() の中では画面と同じ座標で描けばよい（region の外は切り取られる）。
+	 */
+	class RetainedLayer
+	{
+	public:
+
+		explicit RetainedLayer(const Rect& region);
+		virtual ~RetainedLayer();
+
+		void markDirty();
+		bool isDirty() const;
+
+		// 汚れているときだけ drawFunc を呼んで描き直す
+		template<class DrawFunc>
+		void refresh(DrawFunc drawFunc)
+		{
+			if (not(m_isDirty))
+			{
+				return;
+			}
+			{
+				const ScopedRenderTarget2D target{ m_renderTexture.clear(ColorF{ 0.0, 0.0 }) };
+				const ScopedRenderStates2D blend{ GetRefreshBlendState() };
+				// 画面の座標のまま描けるように左上をずらす
+				const Transformer2D transformer{ Mat3x2::Translate(-m_region.pos), TransformCursor::No };
+				drawFunc();
+			}
+			m_isDirty = false;
+			++m_refreshCount;
+		}
+
+		void draw() const;
+
+		const Rect& getRegion() const;
+
+		// 描き直した回数（確認用）
+		size_t getRefreshCount() const;
+
+	private:
+
+		static const BlendState& GetRefreshBlendState();
+
+	private:
+
+		Rect m_region;
+		RenderTexture m_renderTexture;
+		bool m_isDirty;
+		size_t m_refreshCount;
+	};
+}
+
+#endif // !BNSCUP_RETAINEDLAYER_H_
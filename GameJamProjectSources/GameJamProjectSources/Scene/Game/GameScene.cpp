@@ -1,15 +1,26 @@
 ﻿#include "GameScene.h"
 #include "../../Common/Common.h"
+#include "../../Common/FixedTimestep.h"
+#include "../../Memory/HeapCounter.h"
 #include "Map/MapData.h"
 #include "Map/MapView.h"
 #include "Map/RoomData.h"
 #include "Pause/PauseView.h"
-#include "../../Unit/Unit.h"
-#include "../../Unit/Enemy.h"
-#include "../../Item/Item.h"
+#include "Simulation/GameSimulation.h"
+#include "Simulation/GameEvent.h"
+#include "Simulation/Replay.h"
+#include "Simulation/StageData.h"
+#include "../../Unit/UnitStore.h"
+#include "../../Item/ItemStore.h"
+#include "../../Sprite/SpriteDrawList.h"
+#include "../../Particle/ParticleSystem.h"
 #include "../../Button/Button.h"
-#include "../../MessageBox/MessageBox.h"
+#include "../../Input/InputQueue.h"
+#include "../../MessageBox/PopupStack.h"
+#include "../../Text/TextLayout.h"
+#include "../../Text/TextTable.h"
 #include "../../TeleportAnim/TeleportAnim.h"
+#include "../../Sound/SoundManager.h"
 
 namespace
 {
@@ -61,11 +72,48 @@ namespace
 		1120, 670, 80, 40,
 	};
 
+	static const RectF RECT_FORECAST_BUTTON =
+	{
+		850, 670, 80, 40,
+	};
+
+	static const RectF RECT_UNDO_BUTTON =
+	{
+		940, 670, 80, 40,
+	};
+
+	static const RectF RECT_REDO_BUTTON =
+	{
+		1030, 670, 80, 40,
+	};
+
 	static const RectF RECT_PAUSE_BUTTON =
 	{
 		1120, 30, 120, 60,
 	};
 
+	// リプレイ再生時のコマンド間隔（秒）
+	constexpr double REPLAY_COMMAND_INTERVAL = 0.25;
+	constexpr int32 MAX_REPLAY_COMMANDS_PER_FRAME = 64;	// 速度を上げても1フレームで流すのはここまで
+
+	// 救助対象の見た目ごとのアニメーションクリップ名（game_top.json で定義）
+	static const AssetNameView RESCUE_TARGET_CLIP_TABLE[] =
+	{
+		U"anim_rescue_target_0",
+		U"anim_rescue_target_1",
+		U"anim_rescue_target_2",
+	};
+
+	// 敵の動き方ごとのアニメーションクリップ名（EnemyMoveType の順）
+	static const AssetNameView ENEMY_CLIP_TABLE[] =
+	{
+		U"anim_enemy_updown",
+		U"anim_enemy_leftright",
+		U"anim_enemy_chase",
+		U"anim_enemy_patrol",
+		U"anim_enemy_guard",
+	};
+
 	// 描画された最大のアルファ成分を保持するブレンドステートを作成する
 	static const BlendState MakeBlendState()
 	{
@@ -83,14 +131,26 @@ namespace
 		return Vec2{ roomSize.x * 0.5 + roomSize.x * mapPos.x, roomSize.y * 0.5 + roomSize.y * mapPos.y };
 	}
 
-	Point MapPosFromGlobalPos(const Vec2& pos)
+	bnscup::ItemStore::Type KeyItemTypeFromColor(bnscup::RoomData::KeyColor color)
 	{
-		const int32 chipSize = 16;
-		const SizeF roomSize{ chipSize * 5, chipSize * 5 };
-		return Point{
-			static_cast<int32>(pos.x - roomSize.x * 0.5) / static_cast<int32>(roomSize.x),
-			static_cast<int32>(pos.y - roomSize.y * 0.5) / static_cast<int32>(roomSize.y)
-		};
+		switch (color)
+		{
+		case bnscup::RoomData::KeyColor::Silver:	return bnscup::ItemStore::Type::SilverKey;
+		case bnscup::RoomData::KeyColor::Copper:	return bnscup::ItemStore::Type::CopperKey;
+		default:									return bnscup::ItemStore::Type::GoldKey;
+		}
+	}
+
+	bnscup::RoomData::Route RouteFromInputAction(bnscup::InputAction action)
+	{
+		switch (action)
+		{
+		case bnscup::InputAction::Up:		return bnscup::RoomData::Route::Up;
+		case bnscup::InputAction::Right:	return bnscup::RoomData::Route::Right;
+		case bnscup::InputAction::Down:		return bnscup::RoomData::Route::Down;
+		case bnscup::InputAction::Left:		return bnscup::RoomData::Route::Left;
+		default:							return bnscup::RoomData::Route::None;
+		}
 	}
 }
 
@@ -109,29 +169,15 @@ namespace bnscup
 			UseKeyPopup,
 			RescuePopup,
 			ReturnPopup,
-			CommonPopup,
+			CaughtPopup,
 			GameOver,
 			Result,
 			End,
 		};
 
-		struct UnlockRoomData
-		{
-			RoomData* pTargetRoom;
-			RoomData::Route unlockRoute;
-		};
-
-		using Rescued = YesNo<struct Rescued_tag>;
-		struct RescueUnitData
-		{
-			Rescued rescued;
-			Unit* pTargetUnit;
-		};
-
-
 	public:
 
-		Impl(int stageNo);
+		Impl(int stageNo, const ReplayPlayback* pReplayPlayback, SceneArena* pArena, const FixedTimestep* pTimestep);
 		~Impl();
 
 		void update();
@@ -140,6 +186,9 @@ namespace bnscup
 		bool isEnd() const;
 		SceneKey getNextScene() const;
 
+		// 終わったときに出す集計（確認用）
+		String formatStats() const;
+
 	private:
 
 		void stepAssign();
@@ -151,7 +200,7 @@ namespace bnscup
 		void stepUseKeyPopup();
 		void stepRescuePopup();
 		void stepReturnPopup();
-		void stepCommonPopup();
+		void stepCaughtPopup();
 		void stepGameOver();
 		void stepResult();
 
@@ -159,65 +208,117 @@ namespace bnscup
 		void createRescuePopup();
 		void createReturnPopup();
 		void createNotHaveKeyPopup();
-
-		void enemyMove();
-		void checkEnemyMoveDir(Enemy* pEnemy);
+		void createCaughtPopup();
+
+		void applyCommand(GameSimulation::Command command);
+		void pushControlButtonInputs();
+		bool applyMoveInput(const InputEvent& inputEvent);
+		void bufferMoveInputs();
+		void startTurn();
+		void onTurnSettled();
+		void syncPresentation();
+		void dispatchEvents();
+		void updateUnits();
+		void updateStep();
+		void buildSpriteDrawList();
+
+		bool updatePlayback();
+		bool isPlaybackInputStep() const;
+		void saveReplay() const;
 
 	private:
 
+		SceneArena* m_pArena;
+		const FixedTimestep* m_pTimestep;
 		SceneKey m_nextScene;
 
 		Step m_step;
 		Camera2D m_camera;
-		String m_stageNoText;
-		std::unique_ptr<MapData> m_pMapData;
-		std::unique_ptr<MapView> m_pMapView;
+		FormattedText<int32> m_stageNoText;
+		ArenaPtr<GameSimulation> m_pSimulation;
+		GameEventQueue m_events;
+		std::array<uint32, FromEnum(GameEventType::Count)> m_eventCounts;
+		ArenaPtr<MapView> m_pMapView;
 		RenderTexture m_renderTarget;
 
-		Unit* m_pPlayerUnit;
-		Array<std::unique_ptr<Unit>> m_units;
-		Array<RescueUnitData> m_targetUnits;
-		Array<Enemy*> m_enemies;
+		UnitStore m_units;
+		UnitHandle m_playerUnit;
+		Array<UnitHandle> m_rescueTargetUnits;
+		Array<UnitHandle> m_enemyUnits;
+
+		ItemStore m_items;
+		SpriteDrawList m_spriteDrawList;	// ユニットとアイテムを足元の Y 順に描く
 
-		Array<Item*> m_holdKeys;
-		Array<std::unique_ptr<Item>> m_items;
+		InputQueue m_inputQueue;	// 方向の入力（キー、ゲームパッド、画面のボタン）
+		Array<InputEvent> m_bufferedMoves;	// 移動の演出中に入った方向（着いたら順に動く）
 
 		Texture m_controllerTexture;
 		Button m_controlButtons[4];
 		Button m_exitButton;
+		Button m_forecastButton;
+		Button m_undoButton;
+		Button m_redoButton;
 		Button m_pauseButton;
 		PauseView m_pauseView;
 
-		std::unique_ptr<MessageBox> m_pMessageBox;
-		Optional<UnlockRoomData> m_unlockRoomData;
-		RescueUnitData* m_pRescueUnitTarget;
+		PopupStack m_popups;	// 答えを待つポップアップと、止めずに出すお知らせ
 
 		TeleportAnim m_teleportAnim;
+		ParticleSystem m_particles;
+		uint16 m_keyPickupEmitter;
+		uint16 m_doorUnlockEmitter;
+		uint16 m_teleportEmitter;
 
 		Font m_buttonFont;
-		Audio m_collectItemSE;
-		Audio m_unlockDoorSE;
-		Audio m_ingameBGM;
+		// ボタンの文字は変わらないので並べた結果を使い回す
+		const TextLayout* m_pStageNoLayout;
+		const TextLayout* m_pPauseLayout;
+		const TextLayout* m_pExitLayout;
+		const TextLayout* m_pForecastLayout;
+		const TextLayout* m_pUndoLayout;
+		const TextLayout* m_pRedoLayout;
+		SoundId m_collectItemSE;
+		SoundId m_unlockDoorSE;
+		SoundId m_ingameBGM;
+
+		bool m_isForecastVisible;
+
+		int32 m_stepCount;
+		double m_deltaTime;		// 1ステップの長さ
+		double m_frameTime;		// このフレームで進める時間
+		double m_unitAlpha;		// ユニット描画の補間の割合
+		Replay m_replay;
+		Replay m_playbackReplay;
+		size_t m_playbackIndex;
+		double m_playbackSpeed;
+		double m_playbackTimer;
+		bool m_isPlayback;
 	};
 
 	//==================================================
 	
-	GameScene::Impl::Impl(int stageNo)
-		: m_nextScene{ SceneKey::Title }
-		, m_step{ Step::Idle }
+	GameScene::Impl::Impl(int stageNo, const ReplayPlayback* pReplayPlayback, SceneArena* pArena, const FixedTimestep* pTimestep)
+		: m_pArena{ pArena }
+		, m_pTimestep{ pTimestep }
+		, m_nextScene{ SceneKey::Title }
+		, m_step{ Step::Assign }
 		, m_camera{ Vec2::Zero(), 1.0, Camera2DParameters::NoControl() }
-		, m_stageNoText{ U"" }
-		, m_pMapData{ nullptr }
+		, m_stageNoText{ TextId::StageNo }
+		, m_pSimulation{ nullptr }
+		, m_events{}
+		, m_eventCounts{}
 		, m_pMapView{ nullptr }
 		, m_renderTarget{
 			static_cast<uint32>(ROUNDRECT_MAPVIEW_AREA.rect.size.x)
 			, static_cast<uint32>(ROUNDRECT_MAPVIEW_AREA.rect.size.y) }
-		, m_pPlayerUnit{ nullptr }
 		, m_units{}
-		, m_targetUnits{}
-		, m_enemies{}
-		, m_holdKeys{}
+		, m_playerUnit{}
+		, m_rescueTargetUnits{}
+		, m_enemyUnits{}
 		, m_items{}
+		, m_spriteDrawList{}
+		, m_inputQueue{}
+		, m_bufferedMoves{}
 		, m_controllerTexture{}
 		, m_controlButtons{
 			Button(CIRCLE_CONTROLLER_UP_AREA)
@@ -225,367 +326,215 @@ namespace bnscup
 			, Button(CIRCLE_CONTROLLER_LEFT_AREA)
 			, Button(CIRCLE_CONTROLLER_RIGHT_AREA) }
 		, m_exitButton{ RECT_EXIT_BUTTON }
+		, m_forecastButton{ RECT_FORECAST_BUTTON }
+		, m_undoButton{ RECT_UNDO_BUTTON }
+		, m_redoButton{ RECT_REDO_BUTTON }
 		, m_pauseButton{ RECT_PAUSE_BUTTON }
 		, m_pauseView{}
-		, m_pMessageBox{ nullptr }
-		, m_unlockRoomData{ none }
-		, m_pRescueUnitTarget{ nullptr }
+		, m_popups{}
 		, m_teleportAnim{}
+		, m_particles{ PARTICLE_CAPACITY }
+		, m_keyPickupEmitter{ 0 }
+		, m_doorUnlockEmitter{ 0 }
+		, m_teleportEmitter{ 0 }
 		, m_buttonFont{}
-		, m_collectItemSE{}
-		, m_unlockDoorSE{}
-		, m_ingameBGM{}
+		, m_pStageNoLayout{ nullptr }
+		, m_pPauseLayout{ nullptr }
+		, m_pExitLayout{ nullptr }
+		, m_pForecastLayout{ nullptr }
+		, m_pUndoLayout{ nullptr }
+		, m_pRedoLayout{ nullptr }
+		, m_collectItemSE{ INVALID_SOUND_ID }
+		, m_unlockDoorSE{ INVALID_SOUND_ID }
+		, m_ingameBGM{ INVALID_SOUND_ID }
+		, m_isForecastVisible{ false }
+		, m_stepCount{ 0 }
+		, m_deltaTime{ 0.0 }
+		, m_frameTime{ 0.0 }
+		, m_unitAlpha{ 1.0 }
+		, m_replay{}
+		, m_playbackReplay{}
+		, m_playbackIndex{ 0 }
+		, m_playbackSpeed{ 1.0 }
+		, m_playbackTimer{ 0.0 }
+		, m_isPlayback{ false }
 	{
 		// ステージ表示用
-		m_stageNoText = U"ステージ{}"_fmt(stageNo + 1);
+		m_stageNoText.update(stageNo + 1);
 
-		// あとでステージ生成クラスとかにまとめたい
-		if (stageNo == 0)
+		// ルール側の生成
+		StageData stageData;
+		if (not(CreateStageData(stageNo, stageData)))
 		{
-			const int32 chipSize = 16;
-			const int32 roomCountX = 2;
-			const int32 roomCountY = 3;
-
-			// マップの生成
-			auto* pMapData = new MapData(
-				{
-					RoomData{ FromEnum(RoomData::Route::Down)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::None), FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::Up)   }, RoomData{ FromEnum(RoomData::Route::Left), FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::Up)         , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::None), FromEnum(RoomData::Route::None) },
-				},
-				U"dungeon_tileset",
-				roomCountX, roomCountY, chipSize
-			);
-			m_pMapData.reset(pMapData);
-
-			// 救助対象ユニット
-			{
-				auto* pUnit = new Unit();
-				pUnit->setPos(MapPosToGlobalPos(Point{ 0, 0 }));
-				pUnit->setTexture(U"dungeon_tileset_2");
-				pUnit->setAnimRect(
-					{
-						{ 0.175s, RectF{ 128, 256, 16, 32 } },
-						{ 0.175s, RectF{ 144, 256, 16, 32 } },
-						{ 0.175s, RectF{ 160, 256, 16, 32 } },
-						{ 0.175s, RectF{ 176, 256, 16, 32 } },
-					}
-				);
-				m_targetUnits.emplace_back(Rescued::No, pUnit);
-				m_units.emplace_back(pUnit);
-			}
+			CreateStageData(0, stageData);
+		}
+		m_pSimulation = m_pArena->create<GameSimulation>(stageData, GameSimulation::EnableHistory::Yes);
+		m_events.reserve(16 + stageData.keys.size() + stageData.rescueTargets.size());
+		m_pSimulation->setEventQueue(&m_events);
+		m_replay.reset(stageNo);
 
-			const Point startRoom{ 0, 2 };
+		const int32 chipSize = stageData.chipSize;
 
-			// プレイヤーの生成
-			{
-				auto* pPlayerUnit = new Unit();
-				pPlayerUnit->setPos(MapPosToGlobalPos(startRoom));
-				pPlayerUnit->setTexture(U"dungeon_tileset_2");
-				pPlayerUnit->setFootStepSE(U"sd_foot_step");
-				pPlayerUnit->setAnimRect(
-					{
-						{ 0.2s, RectF{ 128, 64, 16, 32 } },
-						{ 0.2s, RectF{ 144, 64, 16, 32 } },
-						{ 0.2s, RectF{ 160, 64, 16, 32 } },
-						{ 0.2s, RectF{ 176, 64, 16, 32 } },
-					}
-				);
-				m_pPlayerUnit = pPlayerUnit;
-				m_units.emplace_back(pPlayerUnit);
-			}
-
-			// アイテムの生成
-			{
-				const Point keyPos{ 1, 1 };
-				auto* pItem = new Item(Item::Type::GoldKey);
-				pItem->setPos(MapPosToGlobalPos(keyPos));
-				pItem->setSrcRect(RectF{ 9 * chipSize, 9 * chipSize, chipSize, chipSize });
-				pItem->setTexture(U"dungeon_tileset");
-				m_items.emplace_back(pItem);
-			}
+		m_units.reserve(stageData.rescueTargets.size() + stageData.enemies.size() + 1);
+		m_bufferedMoves.reserve(MOVE_BUFFER_CAPACITY);
 
+		// 救助対象ユニット（見た目ごとにアニメーションを共有）
+		uint16 rescueTargetAnimIds[std::size(RESCUE_TARGET_CLIP_TABLE)] = {};
+		for (size_t i : step(std::size(RESCUE_TARGET_CLIP_TABLE)))
+		{
+			rescueTargetAnimIds[i] = m_units.addAnimation(RESCUE_TARGET_CLIP_TABLE[i]);
 		}
-		else if (stageNo == 1)
+		for (const auto& target : stageData.rescueTargets)
 		{
-			const int32 chipSize = 16;
-			const int32 roomCountX = 3;
-			const int32 roomCountY = 3;
-
-			// マップの生成
-			auto* pMapData = new MapData(
-				{
-					RoomData{ FromEnum(RoomData::Route::Down)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::Right)        , FromEnum(RoomData::Route::Right) }, RoomData{ FromEnum(RoomData::Route::DownLeft)  , FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None)  }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpRight)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None)  }, RoomData{ FromEnum(RoomData::Route::UpLeft)    , FromEnum(RoomData::Route::None) },
-				},
-				U"dungeon_tileset",
-				roomCountX, roomCountY, chipSize
-				);
-			m_pMapData.reset(pMapData);
-
-			// 救助対象ユニット
-			{
-				auto* pUnit = new Unit();
-				pUnit->setPos(MapPosToGlobalPos(Point{ 1, 0 }));
-				pUnit->setTexture(U"dungeon_tileset_2");
-				pUnit->setAnimRect(
-					{
-						{ 0.175s, RectF{ 128, 256, 16, 32 } },
-						{ 0.175s, RectF{ 144, 256, 16, 32 } },
-						{ 0.175s, RectF{ 160, 256, 16, 32 } },
-						{ 0.175s, RectF{ 176, 256, 16, 32 } },
-					}
-				);
-				m_targetUnits.emplace_back(Rescued::No, pUnit);
-				m_units.emplace_back(pUnit);
-			}
-
-			const Point startRoom{ 0, 1 };
-
-			// プレイヤーの生成
-			{
-				auto* pPlayerUnit = new Unit();
-				pPlayerUnit->setPos(MapPosToGlobalPos(startRoom));
-				pPlayerUnit->setTexture(U"dungeon_tileset_2");
-				pPlayerUnit->setFootStepSE(U"sd_foot_step");
-				pPlayerUnit->setAnimRect(
-					{
-						{ 0.2s, RectF{ 128, 64, 16, 32 } },
-						{ 0.2s, RectF{ 144, 64, 16, 32 } },
-						{ 0.2s, RectF{ 160, 64, 16, 32 } },
-						{ 0.2s, RectF{ 176, 64, 16, 32 } },
-					}
-				);
-				m_pPlayerUnit = pPlayerUnit;
-				m_units.emplace_back(pPlayerUnit);
-			}
-
-			// 敵の生成
-			{
-				auto* pEnemy = new Enemy();
-				pEnemy->setPos(MapPosToGlobalPos(Point{ 2, 0 }));
-				pEnemy->setMoveType(Enemy::MoveType::UpDown);
-				pEnemy->setTexture(U"dungeon_tileset_2");
-				pEnemy->setAnimRect(
-					{
-						{ 0.15s, RectF{ 368, 272, 16, 24 } },
-						{ 0.15s, RectF{ 384, 272, 16, 24 } },
-						{ 0.15s, RectF{ 400, 272, 16, 24 } },
-						{ 0.15s, RectF{ 416, 272, 16, 24 } },
-					}
-				);
-				m_enemies.emplace_back(pEnemy);
-				m_units.emplace_back(pEnemy);
-			}
+			const int32 lookIndex = Clamp<int32>(target.look, 0, static_cast<int32>(std::size(RESCUE_TARGET_CLIP_TABLE)) - 1);
+			m_rescueTargetUnits.push_back(m_units.create(rescueTargetAnimIds[lookIndex], MapPosToGlobalPos(target.pos)));
+		}
 
-			// アイテムの生成
-			{
-				const Point keyPos{ 1, 2 };
-				auto* pItem = new Item(Item::Type::GoldKey);
-				pItem->setPos(MapPosToGlobalPos(keyPos));
-				pItem->setSrcRect(RectF{ 9 * chipSize, 9 * chipSize, chipSize, chipSize });
-				pItem->setTexture(U"dungeon_tileset");
-				m_items.emplace_back(pItem);
-			}
+		// アイテムの生成
+		m_items.reserve(stageData.keys.size());
+		for (const auto& key : stageData.keys)
+		{
+			// 絵は1種類なので色で塗り分ける
+			m_items.add(KeyItemTypeFromColor(key.color), MapPosToGlobalPos(key.pos), U"dungeon_tileset", RectF{ 9 * chipSize, 9 * chipSize, chipSize, chipSize }, MapView::GetKeyColorTint(key.color));
+		}
 
+		// 敵の生成（動き方ごとにアニメーションを共有）
+		uint16 enemyAnimIds[std::size(ENEMY_CLIP_TABLE)] = {};
+		for (size_t i : step(std::size(ENEMY_CLIP_TABLE)))
+		{
+			enemyAnimIds[i] = m_units.addAnimation(ENEMY_CLIP_TABLE[i]);
 		}
-		else if (stageNo == 2)
+		for (const auto& enemy : stageData.enemies)
 		{
-			const int32 chipSize = 16;
-			const int32 roomCountX = 6;
-			const int32 roomCountY = 5;
-
-			// マップの生成
-			auto* pMapData = new MapData(
-				{
-					RoomData{ FromEnum(RoomData::Route::Right)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::Left) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightLeft)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft)   , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::Down)      , FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::RightDown)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::All)          , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft)     , FromEnum(RoomData::Route::Down) }, RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft)   , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRight)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft) , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDown)    , FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpDown)     , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightDown)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::All)          , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
-					RoomData{ FromEnum(RoomData::Route::UpRight)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)       , FromEnum(RoomData::Route::Left) }, RoomData{ FromEnum(RoomData::Route::Right)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)    , FromEnum(RoomData::Route::None) },
-				},
-				U"dungeon_tileset",
-				roomCountX, roomCountY, chipSize
-				);
-			m_pMapData.reset(pMapData);
-
-			// 救助対象ユニット
-			{
-				auto* pUnit = new Unit();
-				pUnit->setPos(MapPosToGlobalPos(Point{ 0, 0 }));
-				pUnit->setTexture(U"dungeon_tileset_2");
-				pUnit->setAnimRect(
-					{
-						{ 0.175s, RectF{ 128, 256, 16, 32 } },
-						{ 0.175s, RectF{ 144, 256, 16, 32 } },
-						{ 0.175s, RectF{ 160, 256, 16, 32 } },
-						{ 0.175s, RectF{ 176, 256, 16, 32 } },
-					}
-				);
-				m_targetUnits.emplace_back(Rescued::No, pUnit);
-				m_units.emplace_back(pUnit);
-			}
-			{
-				auto* pUnit = new Unit();
-				pUnit->setPos(MapPosToGlobalPos(Point{ 3, 4 }));
-				pUnit->setTexture(U"dungeon_tileset_2");
-				pUnit->setAnimRect(
-					{
-						{ 0.175s, RectF{ 128, 288, 16, 32 } },
-						{ 0.175s, RectF{ 144, 288, 16, 32 } },
-						{ 0.175s, RectF{ 160, 288, 16, 32 } },
-						{ 0.175s, RectF{ 176, 288, 16, 32 } },
-					}
-				);
-				m_targetUnits.emplace_back(Rescued::No, pUnit);
-				m_units.emplace_back(pUnit);
-			}
-			{
-				auto* pUnit = new Unit();
-				pUnit->setPos(MapPosToGlobalPos(Point{ 3, 2 }));
-				pUnit->setTexture(U"dungeon_tileset_2");
-				pUnit->setAnimRect(
-					{
-						{ 0.175s, RectF{ 128, 32, 16, 32 } },
-						{ 0.175s, RectF{ 144, 32, 16, 32 } },
-						{ 0.175s, RectF{ 160, 32, 16, 32 } },
-						{ 0.175s, RectF{ 176, 32, 16, 32 } },
-					}
-				);
-				m_targetUnits.emplace_back(Rescued::No, pUnit);
-				m_units.emplace_back(pUnit);
-			}
-
-			// アイテムの生成
-			const Point KeyPositions[] =
-			{
-				{ 0, 1 },
-				{ 0, 4 },
-				{ 5, 0 },
-			};
-			for (const auto& keyPos : KeyPositions)
-			{
-				auto* pItem = new Item(Item::Type::GoldKey);
-				pItem->setPos(MapPosToGlobalPos(keyPos));
-				pItem->setSrcRect(RectF{ 9 * chipSize, 9 * chipSize, chipSize, chipSize });
-				pItem->setTexture(U"dungeon_tileset");
-				m_items.emplace_back(pItem);
-			}
-
-			// 敵の生成
-			{
-				auto* pEnemy = new Enemy();
-				pEnemy->setPos(MapPosToGlobalPos(Point{ 4, 0 }));
-				pEnemy->setMoveType(Enemy::MoveType::UpDown);
-				pEnemy->setTexture(U"dungeon_tileset_2");
-				pEnemy->setAnimRect(
-					{
-						{ 0.15s, RectF{ 368, 272, 16, 24 } },
-						{ 0.15s, RectF{ 384, 272, 16, 24 } },
-						{ 0.15s, RectF{ 400, 272, 16, 24 } },
-						{ 0.15s, RectF{ 416, 272, 16, 24 } },
-					}
-				);
-				m_enemies.emplace_back(pEnemy);
-				m_units.emplace_back(pEnemy);
-			}
-			{
-				auto* pEnemy = new Enemy();
-				pEnemy->setPos(MapPosToGlobalPos(Point{ 1, 0 }));
-				pEnemy->setMoveType(Enemy::MoveType::LeftRight);
-				pEnemy->setMoveDirection(RoomData::Route::Right);
-				pEnemy->setTexture(U"dungeon_tileset_2");
-				pEnemy->setAnimRect(
-					{
-						{ 0.15s, RectF{ 368, 248, 16, 24 } },
-						{ 0.15s, RectF{ 384, 248, 16, 24 } },
-						{ 0.15s, RectF{ 400, 248, 16, 24 } },
-						{ 0.15s, RectF{ 416, 248, 16, 24 } },
-					}
-				);
-				m_enemies.emplace_back(pEnemy);
-				m_units.emplace_back(pEnemy);
-			}
-			{
-				auto* pEnemy = new Enemy();
-				pEnemy->setPos(MapPosToGlobalPos(Point{ 5, 3 }));
-				pEnemy->setMoveType(Enemy::MoveType::LeftRight);
-				pEnemy->setMoveDirection(RoomData::Route::Left);
-				pEnemy->setMirror(true);
-				pEnemy->setTexture(U"dungeon_tileset_2");
-				pEnemy->setAnimRect(
-					{
-						{ 0.15s, RectF{ 368, 248, 16, 24 } },
-						{ 0.15s, RectF{ 384, 248, 16, 24 } },
-						{ 0.15s, RectF{ 400, 248, 16, 24 } },
-						{ 0.15s, RectF{ 416, 248, 16, 24 } },
-					}
-				);
-				m_enemies.emplace_back(pEnemy);
-				m_units.emplace_back(pEnemy);
-			}
-
-			const Point startRoom{ 2, 2 };
+			const size_t moveTypeIndex = Min<size_t>(FromEnum(enemy.moveType), std::size(ENEMY_CLIP_TABLE) - 1);
+			const auto enemyUnit = m_units.create(enemyAnimIds[moveTypeIndex], MapPosToGlobalPos(enemy.pos));
+			m_units.setMirror(enemyUnit, enemy.moveDirection == RoomData::Route::Left);
+			m_enemyUnits.push_back(enemyUnit);
+		}
 
-			// プレイヤーの生成
-			{
-				auto* pPlayerUnit = new Unit();
-				pPlayerUnit->setPos(MapPosToGlobalPos(startRoom));
-				pPlayerUnit->setTexture(U"dungeon_tileset_2");
-				pPlayerUnit->setFootStepSE(U"sd_foot_step");
-				pPlayerUnit->setAnimRect(
-					{
-						{ 0.2s, RectF{ 128, 64, 16, 32 } },
-						{ 0.2s, RectF{ 144, 64, 16, 32 } },
-						{ 0.2s, RectF{ 160, 64, 16, 32 } },
-						{ 0.2s, RectF{ 176, 64, 16, 32 } },
-					}
-				);
-				m_pPlayerUnit = pPlayerUnit;
-				m_units.emplace_back(pPlayerUnit);
-			}
+		// プレイヤーの生成
+		{
+			const uint16 playerAnimId = m_units.addAnimation(U"anim_player");
+			m_playerUnit = m_units.create(playerAnimId, MapPosToGlobalPos(stageData.startRoom));
+			m_units.setFootStepSE(m_playerUnit, SoundManager::Register(U"sd_foot_step", SoundCategory::FootStep, 0, 0.1));
 		}
+		m_spriteDrawList.reserve(m_units.getCount() + m_items.getCount());
 
 		// カメラの設定
 		{
 			m_camera.setScale(1.9);
 			m_camera.setTargetScale(1.9);
-			m_camera.setCenter(m_pPlayerUnit->getPos());
-			m_camera.setTargetCenter(m_pPlayerUnit->getPos());
+			m_camera.setCenter(m_units.getPos(m_playerUnit));
+			m_camera.setTargetCenter(m_units.getPos(m_playerUnit));
 		}
 
-		if (m_pMapData)
-		{
-			auto* pMapView = new MapView(m_pMapData.get());
-			m_pMapView.reset(pMapView);
-		}
+		m_pMapView = m_pArena->create<MapView>(&(m_pSimulation->getMapData()));
 
 		// ポーズ画面は閉じておく
 		m_pauseView.setEnable(false);
 
 		m_controllerTexture = TextureAsset(U"controller_switch");
 		m_buttonFont = FontAsset(U"font_button");
-		m_collectItemSE = AudioAsset(U"sd_collect_item");
-		m_unlockDoorSE = AudioAsset(U"sd_unlock_door");
-		m_ingameBGM = AudioAsset(U"sd_bgm_ingame");
-		m_ingameBGM.setLoop(true);
-		m_ingameBGM.setVolume(0.075);
-		m_ingameBGM.play();
+		m_pStageNoLayout = TextLayoutCache::Get(m_buttonFont, m_stageNoText.get());
+		m_pPauseLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::GamePause));
+		m_pExitLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::GameExit));
+		m_pForecastLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::GameForecast));
+		m_pUndoLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::GameUndo));
+		m_pRedoLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::GameRedo));
+		// 音は名前から一度だけ引いておく
+		m_collectItemSE = SoundManager::Register(U"sd_collect_item", SoundCategory::Gameplay, 5, 1.0);
+		m_unlockDoorSE = SoundManager::Register(U"sd_unlock_door", SoundCategory::Gameplay, 5, 1.0);
+		m_ingameBGM = SoundManager::Register(U"sd_bgm_ingame", SoundCategory::BGM, 0, 0.075);
+		SoundManager::PlayBGM(m_ingameBGM);
+		// パーティクルの出し方もパックから一度だけ引いておく
+		m_keyPickupEmitter = m_particles.addEmitter(U"pt_key_pickup");
+		m_doorUnlockEmitter = m_particles.addEmitter(U"pt_door_unlock");
+		m_teleportEmitter = m_particles.addEmitter(U"pt_teleport");
+
+		// リプレイ再生
+		if (pReplayPlayback)
+		{
+			m_playbackReplay = pReplayPlayback->replay;
+			m_playbackSpeed = pReplayPlayback->speed;
+			m_isPlayback = true;
+			if (pReplayPlayback->isSkipAnim)
+			{
+				// 演出なしで最終状態まで進める（途中のイベントは見せないので積まない）
+				m_pSimulation->setEventQueue(nullptr);
+				Stopwatch stopwatch{ StartImmediately::Yes };
+				m_playbackIndex = m_playbackReplay.applyTo(*m_pSimulation, m_playbackReplay.getCommandCount());
+				const auto elapsed = stopwatch.us();
+				m_pSimulation->setEventQueue(&m_events);
+				for (size_t i : step(m_playbackIndex))
+				{
+					m_replay.record(m_playbackReplay.getCommand(i));
+				}
+				Logger << U"replay: {} commands, {} turns, {} us"_fmt(m_playbackIndex, m_pSimulation->getTurn(), elapsed);
+				syncPresentation();
+				m_isPlayback = false;
+				m_playbackSpeed = 1.0;
+			}
+		}
+
+		// 最初の update() より前のフェードイン中にも描けるようにしておく
+		buildSpriteDrawList();
 	}
 
 	GameScene::Impl::~Impl()
 	{
 	}
 
+	String GameScene::Impl::formatStats() const
+	{
+		uint32 eventCount = 0;
+		for (const uint32 count : m_eventCounts)
+		{
+			eventCount += count;
+		}
+		const auto& soundStats = SoundManager::GetStats();
+		return U"arena {} ({} bytes used), events {}, sound play {} steal {} drop {}, particles peak {} dropped {}, input delay {}"_fmt(
+			m_pArena->getStats().format(), m_pArena->getUsedBytes(), eventCount,
+			soundStats.playCount, soundStats.stealCount, soundStats.dropCount,
+			m_particles.getPeakCount(), m_particles.getDroppedCount(), m_inputQueue.getDelayStats().format());
+	}
+
 	void GameScene::Impl::update()
 	{
-		if (m_pPlayerUnit)
+		// 入力はフレームの最初にまとめて読む
+		m_inputQueue.poll();
+
+		// 時間で動くものは決まった長さのステップで進める（入力を見るのはフレームに1回）
+		m_stepCount = m_pTimestep->getStepCount();
+		m_deltaTime = m_pTimestep->getStepTime() * m_playbackSpeed;
+		m_frameTime = m_deltaTime * m_stepCount;
+		// ユニットを進めないフレームは今の状態をそのまま描く
+		m_unitAlpha = 1.0;
+
+		if (m_units.isAlive(m_playerUnit))
 		{
-			m_camera.setTargetCenter(m_pPlayerUnit->getPos());
+			m_camera.setTargetCenter(m_units.getPos(m_playerUnit));
 		}
 		m_camera.update();
 
+		dispatchEvents();
+		m_particles.update(m_frameTime);
+
+		if (not(m_isPlayback and updatePlayback()))
+		{
+			updateStep();
+		}
+		// お知らせはポーズ中以外なら何をしていても閉じられる
+		if (m_step != Step::Pause)
+		{
+			m_popups.updateNotice();
+		}
+
+		// 位置が決まってから描く順番を決める
+		buildSpriteDrawList();
+	}
+
+	void GameScene::Impl::updateStep()
+	{
 		switch (m_step)
 		{
 		case Step::Assign:		stepAssign();		break;
@@ -597,7 +546,7 @@ namespace bnscup
 		case Step::UseKeyPopup:	stepUseKeyPopup();	break;
 		case Step::RescuePopup:	stepRescuePopup();	break;
 		case Step::ReturnPopup:	stepReturnPopup();	break;
-		case Step::CommonPopup:	stepCommonPopup();	break;
+		case Step::CaughtPopup:	stepCaughtPopup();	break;
 		case Step::GameOver:	stepGameOver();		break;
 		case Step::Result:		stepResult();		break;
 		case Step::End:			break;
@@ -608,13 +557,13 @@ namespace bnscup
 	void GameScene::Impl::draw() const
 	{
 		ROUNDRECT_STAGENO_AREA.draw(Palette::Darkslategray).drawFrame(2.0, Palette::Darkgray);
-		m_buttonFont(m_stageNoText).drawAt(ROUNDRECT_STAGENO_AREA.center());
+		m_pStageNoLayout->drawAt(ROUNDRECT_STAGENO_AREA.center());
 
 		// ポーズボタン
 		{
 			const auto& buttonRect = m_pauseButton.getRect();
 			buttonRect.rounded(3).draw(Palette::Darkolivegreen).drawFrame(1.0, Palette::Black);
-			m_buttonFont(U"PAUSE").drawAt(buttonRect.center(), Palette::Black);
+			m_pPauseLayout->drawAt(buttonRect.center(), Palette::Black);
 		}
 
 		ROUNDRECT_MAPVIEW_AREA.draw(Palette::Darkslategray).drawFrame(2.0, Palette::Darkgray);
@@ -646,29 +595,27 @@ namespace bnscup
 				m_pMapView->draw();
 			}
 
-			for (const auto& item : m_items)
+			// 次の手で敵が来る部屋（往復、巡回する敵のみ）
+			if (m_isForecastVisible and m_step == Step::Idle)
 			{
-				if (item)
+				const auto& forecast = m_pSimulation->getEnemyForecast();
+				const uint32 nextTurn = m_pSimulation->getTurn() + 1;
+				const auto& mapSize = m_pSimulation->getMapData().getMapSize();
+				const int32 roomSize = m_pSimulation->getMapData().getChipSize() * 5;
+				for (int32 y : step(mapSize.y))
 				{
-					if (item->existOwer())
+					for (int32 x : step(mapSize.x))
 					{
-						continue;
+						if (forecast.isDangerous(Point{ x, y }, nextTurn))
+						{
+							RectF{ Arg::center = MapPosToGlobalPos(Point{ x, y }), roomSize, roomSize }.draw(ColorF{ 1.0, 0.0, 0.0, 0.3 });
+						}
 					}
-					item->draw();
 				}
 			}
 
-			for (const auto& unit : m_units)
-			{
-				if (unit)
-				{
-					if (not(unit->isEnable()))
-					{
-						continue;
-					}
-					unit->draw();
-				}
-			}
+			m_spriteDrawList.draw();
+			m_particles.draw();
 			m_teleportAnim.draw();
 		}
 		m_renderTarget.rounded(ROUNDRECT_MAPVIEW_AREA.r).drawAt(ROUNDRECT_MAPVIEW_AREA.center());
@@ -677,16 +624,34 @@ namespace bnscup
 		{
 			const auto& buttonRect = m_exitButton.getRect();
 			buttonRect.rounded(3).draw(Palette::Darkred).drawFrame(1.0, Palette::Black);
-			m_buttonFont(U"脱出").drawAt(buttonRect.center(), Palette::Black);
+			m_pExitLayout->drawAt(buttonRect.center(), Palette::Black);
 		}
 
-		// ポーズウィンドウ
-		m_pauseView.draw();
+		// 先読み表示ボタン
+		{
+			const auto& buttonRect = m_forecastButton.getRect();
+			const ColorF buttonColor = m_isForecastVisible ? ColorF{ Palette::Darkorange } : ColorF{ Palette::Dimgray };
+			buttonRect.rounded(3).draw(buttonColor).drawFrame(1.0, Palette::Black);
+			m_pForecastLayout->drawAt(buttonRect.center(), Palette::Black);
+		}
 
-		if (m_pMessageBox)
+		// 戻す・進むボタン
 		{
-			m_pMessageBox->draw();
+			const auto& undoRect = m_undoButton.getRect();
+			const ColorF undoColor = m_pSimulation->canUndo() ? ColorF{ Palette::Darkolivegreen } : ColorF{ Palette::Dimgray };
+			undoRect.rounded(3).draw(undoColor).drawFrame(1.0, Palette::Black);
+			m_pUndoLayout->drawAt(undoRect.center(), Palette::Black);
+
+			const auto& redoRect = m_redoButton.getRect();
+			const ColorF redoColor = m_pSimulation->canRedo() ? ColorF{ Palette::Darkolivegreen } : ColorF{ Palette::Dimgray };
+			redoRect.rounded(3).draw(redoColor).drawFrame(1.0, Palette::Black);
+			m_pRedoLayout->drawAt(redoRect.center(), Palette::Black);
 		}
+
+		m_popups.draw();
+
+		// ポーズウィンドウ（お知らせより上）
+		m_pauseView.draw();
 	}
 
 	bool GameScene::Impl::isEnd() const
@@ -701,18 +666,13 @@ namespace bnscup
 
 	void GameScene::Impl::stepAssign()
 	{
-		m_step = Step::Idle;
+		// 開始位置での判定結果を反映
+		onTurnSettled();
 	}
 
 	void GameScene::Impl::stepIdle()
 	{
-		for (auto& unit : m_units)
-		{
-			if (unit)
-			{
-				unit->update();
-			}
-		}
+		updateUnits();
 
 		for (auto& button : m_controlButtons)
 		{
@@ -723,6 +683,14 @@ namespace bnscup
 
 		m_exitButton.update();
 
+		m_forecastButton.update();
+
+		m_undoButton.setEnable(m_pSimulation->canUndo());
+		m_undoButton.update();
+
+		m_redoButton.setEnable(m_pSimulation->canRedo());
+		m_redoButton.update();
+
 		if (m_pauseButton.isSelected(Button::Sounds::Select))
 		{
 			m_pauseView.setEnable(true);
@@ -732,215 +700,88 @@ namespace bnscup
 
 		if (m_exitButton.isSelected(Button::Sounds::Select))
 		{
-			createReturnPopup();
+			applyCommand(GameSimulation::Command::Escape);
 			return;
 		}
 
-
-		if (m_pPlayerUnit)
+		if (m_forecastButton.isSelected(Button::Sounds::Select))
 		{
-			const auto& playerPos = MapPosFromGlobalPos(m_pPlayerUnit->getPos());
-			for (auto& item : m_items)
-			{
-				if (item->existOwer())
-				{
-					continue;
-				}
+			m_isForecastVisible = not(m_isForecastVisible);
+			return;
+		}
 
-				// 鍵との判定
-				if (item->isKey())
-				{
-					const auto& itemPos = MapPosFromGlobalPos(item->getPos());
-					if (itemPos == playerPos)
-					{
-						item->setOwner(m_pPlayerUnit);
-						m_holdKeys.emplace_back(item.get());
-						m_collectItemSE.playOneShot();
-						break;
-					}
-				}
-			}
-			for (auto& pEnemy : m_enemies)
-			{
-				if (pEnemy)
-				{
-					if (not(pEnemy->isEnable()))
-					{
-						continue;
-					}
-					const auto& enemyPos = MapPosFromGlobalPos(pEnemy->getPos());
-					if (playerPos == enemyPos)
-					{
-						m_step = Step::GameOver;
-						return;
-					}
-				}
-			}
+		if (m_undoButton.isSelected(Button::Sounds::Select))
+		{
+			applyCommand(GameSimulation::Command::Undo);
+			return;
+		}
 
-			for (auto& targetUnit : m_targetUnits)
-			{
-				// 救助済み
-				if (targetUnit.rescued)
-				{
-					continue;
-				}
-				const auto& targetPos = MapPosFromGlobalPos(targetUnit.pTargetUnit->getPos());
-				if (targetPos == playerPos)
-				{
-					m_pRescueUnitTarget = &targetUnit;
-					createRescuePopup();
-					return;
-				}
-			}
+		if (m_redoButton.isSelected(Button::Sounds::Select))
+		{
+			applyCommand(GameSimulation::Command::Redo);
+			return;
 		}
 
-		// 入れ子パラダイス
-		// 後で別にまとめる
-		// 通れるか、鍵を使用するかの確認
+		// 移動の入力（画面のボタンもキーと同じく押したときに積む）
+		pushControlButtonInputs();
+		InputEvent inputEvent{};
+		if (m_inputQueue.pop(inputEvent))
 		{
-			static const std::pair<RoomData::Route, RoomData::Route> ROUTE_TABLE[] = {
-				{ RoomData::Route::Up, RoomData::Route::Down },
-				{ RoomData::Route::Down, RoomData::Route::Up },
-				{ RoomData::Route::Left, RoomData::Route::Right },
-				{ RoomData::Route::Right, RoomData::Route::Left }
-			};
-			for (size_t i : step(std::size(m_controlButtons)))
-			{
-				if (m_controlButtons[i].isSelected(Button::Sounds::Select))
-				{
-					Point mapPos = MapPosFromGlobalPos(m_pPlayerUnit->getPos());
-					auto& nowRoom = m_pMapData->getRoomData(mapPos);
-					const auto& route = ROUTE_TABLE[i];
-					if (route.first == RoomData::Route::Left)
-					{
-						m_pPlayerUnit->setMirror(true);
-					}
-					else if (route.first == RoomData::Route::Right)
-					{
-						m_pPlayerUnit->setMirror(false);
-					}
-					if (nowRoom.canPassable(route.first))
-					{
-						if (nowRoom.isLocked(route.first))
-						{
-							// 鍵がかかっている
-							if (m_holdKeys.size() > 0)
-							{
-								m_unlockRoomData.emplace(&nowRoom, route.first);
-								createUseKeyPopup();
-								return;
-							}
-							else
-							{
-								createNotHaveKeyPopup();
-								return;
-							}
-						}
-						else
-						{
-							// 移動先
-							switch (route.first)
-							{
-							case bnscup::RoomData::Route::Up:
-								mapPos.y -= 1;
-								break;
-							case bnscup::RoomData::Route::Right:
-								mapPos.x += 1;
-								break;
-							case bnscup::RoomData::Route::Down:
-								mapPos.y += 1;
-								break;
-							case bnscup::RoomData::Route::Left:
-								mapPos.x -= 1;
-								break;
-							default:
-								DEBUG_BREAK(true);
-								break;
-							}
-							// 移動先に敵がいないか確認
-							for (auto& pEnemy : m_enemies)
-							{
-								const auto& enemyPos = MapPosFromGlobalPos(pEnemy->getPos());
-								if (mapPos == enemyPos)
-								{
-									const auto& playerMoveDir = route.first;
-									const auto& enemyMoveDir = pEnemy->getMoveDirection();
-									// 移動方向に対して向かい合っているか
-									// ルート用のクラスに分けて計算できると楽
-									if (
-										   (playerMoveDir == RoomData::Route::Up    and enemyMoveDir == RoomData::Route::Down )
-										or (playerMoveDir == RoomData::Route::Right and enemyMoveDir == RoomData::Route::Left )
-										or (playerMoveDir == RoomData::Route::Down  and enemyMoveDir == RoomData::Route::Up   )
-										or (playerMoveDir == RoomData::Route::Left  and enemyMoveDir == RoomData::Route::Right)
-										)
-									{
-										enemyMove();
-										m_step = Step::Move;
-										return;
-									}
-								}
-							}
-							auto& targetRoom = m_pMapData->getRoomData(mapPos);
-							if (targetRoom.canPassable(route.second))
-							{
-								if (targetRoom.isLocked(route.second))
-								{
-									// 鍵がかかっている
-									if (m_holdKeys.size() > 0)
-									{
-										m_unlockRoomData.emplace(&targetRoom, route.second);
-										createUseKeyPopup();
-										return;
-									}
-									else
-									{
-										createNotHaveKeyPopup();
-										return;
-									}
-								}
-								else
-								{
-									// 通れる
-									m_pPlayerUnit->setTargetPos(MapPosToGlobalPos(mapPos));
-									enemyMove();
-									m_step = Step::Move;
-									return;
-								}
-							}
-						}
-					}
-				}
-			}
+			applyMoveInput(inputEvent);
+			return;
 		}
-		
 	}
 
 	void GameScene::Impl::stepMove()
 	{
-		bool isMoving = false;
-		for (auto& unit : m_units)
+		updateUnits();
+
+		// 動いている間の方向の入力は捨てずに溜めておく
+		if (not(m_isPlayback))
 		{
-			if (unit)
+			for (auto& button : m_controlButtons)
 			{
-				unit->update();
-				if (unit->isMoving())
-				{
-					isMoving = true;
-				}
+				button.update();
 			}
+			pushControlButtonInputs();
+			bufferMoveInputs();
 		}
-		if (isMoving)
+
+		if (m_units.isAnyMoving())
 		{
 			return;
 		}
 
-
-		for (auto& pEnemy : m_enemies)
+		// 移動後の向きを反映
+		const auto& enemies = m_pSimulation->getEnemies();
+		for (size_t i : step(enemies.size()))
 		{
-			checkEnemyMoveDir(pEnemy);
+			if (enemies[i].moveDirection == RoomData::Route::Left)
+			{
+				m_units.setMirror(m_enemyUnits[i], true);
+			}
+			else if (enemies[i].moveDirection == RoomData::Route::Right)
+			{
+				m_units.setMirror(m_enemyUnits[i], false);
+			}
 		}
 
-		m_step = Step::Idle;
+		onTurnSettled();
+
+		// 溜めておいた入力があれば待たずに次の手を始める
+		if (m_step == Step::Idle and not(m_bufferedMoves.isEmpty()))
+		{
+			// 着いた手のイベントは次の手を始める前に反映しておく
+			dispatchEvents();
+			const InputEvent inputEvent = m_bufferedMoves.front();
+			m_bufferedMoves.pop_front();
+			if (applyMoveInput(inputEvent))
+			{
+				return;
+			}
+		}
+		// 続けて動けない（壁、ポップアップなど）場合は残りを捨てて、プレイヤーに判断してもらう
+		m_bufferedMoves.clear();
 	}
 
 	void GameScene::Impl::stepPause()
@@ -964,31 +805,27 @@ namespace bnscup
 			m_nextScene = SceneKey::Title;
 			nextStep = Step::End;
 		}
+		if (nextStep == Step::End)
+		{
+			saveReplay();
+		}
 		m_step = nextStep;
 	}
 
 	void GameScene::Impl::stepRescueAnim()
 	{
-		m_teleportAnim.update();
+		m_teleportAnim.update(m_frameTime);
 		if (not(m_teleportAnim.isEnd()))
 		{
 			return;
 		}
 		m_teleportAnim.reset();
-		for (const auto& targetUnit : m_targetUnits)
-		{
-			if (not(targetUnit.rescued))
-			{
-				m_step = Step::Idle;
-				return;
-			}
-		}
-		createReturnPopup();
+		onTurnSettled();
 	}
 
 	void GameScene::Impl::stepReturnAnim()
 	{
-		m_teleportAnim.update();
+		m_teleportAnim.update(m_frameTime);
 		if (not(m_teleportAnim.isEnd()))
 		{
 			return;
@@ -999,27 +836,26 @@ namespace bnscup
 
 	void GameScene::Impl::stepUseKeyPopup()
 	{
-		if (m_pMessageBox.get() == nullptr)
+		MessageBox* pMessageBox = m_popups.getTop();
+		if (pMessageBox == nullptr)
 		{
 			DEBUG_BREAK(true); // 処理しようがない。
-			m_step = Step::Idle;
+			applyCommand(GameSimulation::Command::No);
 			return;
 		}
 
-		m_pMessageBox->update();
+		pMessageBox->update();
 
-		if (m_pMessageBox->isYesSelected())
+		GameSimulation::Command command = GameSimulation::Command::None;
+		if (pMessageBox->isYesSelected())
 		{
 			// アンロック
-			if (m_unlockRoomData)
-			{
-				m_unlockRoomData->pTargetRoom->unlock(m_unlockRoomData->unlockRoute);
-				m_unlockDoorSE.playOneShot();
-			}
+			command = GameSimulation::Command::Yes;
 		}
-		else if (m_pMessageBox->isNoSelected() or m_pMessageBox->isExitCrossSelected())
+		else if (pMessageBox->isNoSelected() or pMessageBox->isExitCrossSelected())
 		{
 			// メッセージキャンセル
+			command = GameSimulation::Command::No;
 		}
 		else
 		{
@@ -1027,36 +863,32 @@ namespace bnscup
 		}
 
 		// 処理終わり
-		m_unlockRoomData.reset();
-		m_pMessageBox.reset();
-		m_step = Step::Idle;
+		m_popups.pop();
+		applyCommand(command);
 	}
 
 	void GameScene::Impl::stepRescuePopup()
 	{
-		if (m_pMessageBox.get() == nullptr)
+		MessageBox* pMessageBox = m_popups.getTop();
+		if (pMessageBox == nullptr)
 		{
 			DEBUG_BREAK(true); // 処理しようがない。
-			m_pRescueUnitTarget = nullptr;
-			m_step = Step::Idle;
+			applyCommand(GameSimulation::Command::No);
 			return;
 		}
 
-		m_pMessageBox->update();
+		pMessageBox->update();
 
-		Step nextStep = Step::Idle;
-		if (m_pMessageBox->isYesSelected())
+		GameSimulation::Command command = GameSimulation::Command::None;
+		if (pMessageBox->isYesSelected())
 		{
-			m_pRescueUnitTarget->rescued = Rescued::Yes;
-			m_pRescueUnitTarget->pTargetUnit->setEnable(false);
-			m_teleportAnim.setPos(m_pRescueUnitTarget->pTargetUnit->getPos());
-			m_teleportAnim.reset();
-			m_teleportAnim.setEnable(true);
-			nextStep = Step::RescueAnim;
+			// 救助
+			command = GameSimulation::Command::Yes;
 		}
-		else if (m_pMessageBox->isNoSelected() or m_pMessageBox->isExitCrossSelected())
+		else if (pMessageBox->isNoSelected() or pMessageBox->isExitCrossSelected())
 		{
 			// メッセージキャンセル
+			command = GameSimulation::Command::No;
 		}
 		else
 		{
@@ -1064,36 +896,33 @@ namespace bnscup
 		}
 
 		// 処理終わり
-		m_pRescueUnitTarget = nullptr;
-		m_pMessageBox.reset();
-		m_step = nextStep;
+		m_popups.pop();
+		applyCommand(command);
 	}
 
 	void GameScene::Impl::stepReturnPopup()
 	{
-		if (m_pMessageBox.get() == nullptr
-			or m_pPlayerUnit == nullptr)
+		MessageBox* pMessageBox = m_popups.getTop();
+		if (pMessageBox == nullptr
+			or not(m_units.isAlive(m_playerUnit)))
 		{
 			DEBUG_BREAK(true); // 処理しようがない。
-			m_step = Step::Idle;
+			applyCommand(GameSimulation::Command::No);
 			return;
 		}
 
-		m_pMessageBox->update();
+		pMessageBox->update();
 
-		Step nextStep = Step::Idle;
-		if (m_pMessageBox->isYesSelected())
+		GameSimulation::Command command = GameSimulation::Command::None;
+		if (pMessageBox->isYesSelected())
 		{
-			m_teleportAnim.setPos(m_pPlayerUnit->getPos());
-			m_teleportAnim.reset();
-			m_teleportAnim.setEnable(true);
-			m_pPlayerUnit->setEnable(false);
-			m_pPlayerUnit = nullptr;
-			nextStep = Step::ReturnAnim;
+			// 脱出
+			command = GameSimulation::Command::Yes;
 		}
-		else if (m_pMessageBox->isNoSelected() or m_pMessageBox->isExitCrossSelected())
+		else if (pMessageBox->isNoSelected() or pMessageBox->isExitCrossSelected())
 		{
 			// メッセージキャンセル
+			command = GameSimulation::Command::No;
 		}
 		else
 		{
@@ -1101,24 +930,33 @@ namespace bnscup
 		}
 
 		// 処理終わり
-		m_pMessageBox.reset();
-		m_step = nextStep;
+		m_popups.pop();
+		applyCommand(command);
 	}
 
-	void GameScene::Impl::stepCommonPopup()
+	void GameScene::Impl::stepCaughtPopup()
 	{
-		if (m_pMessageBox.get() == nullptr)
+		MessageBox* pMessageBox = m_popups.getTop();
+		if (pMessageBox == nullptr)
 		{
-			DEBUG_BREAK(true);
+			DEBUG_BREAK(true); // 処理しようがない。
+			m_step = Step::GameOver;
 			return;
 		}
 
-		m_pMessageBox->update();
+		pMessageBox->update();
 
-		if (m_pMessageBox->isOKSelected())
+		if (pMessageBox->isYesSelected())
 		{
-			m_pMessageBox.reset();
-			m_step = Step::Idle;
+			// 捕まる前に戻す
+			m_popups.pop();
+			applyCommand(GameSimulation::Command::Undo);
+			return;
+		}
+		else if (pMessageBox->isNoSelected() or pMessageBox->isExitCrossSelected())
+		{
+			m_popups.pop();
+			m_step = Step::GameOver;
 			return;
 		}
 	}
@@ -1127,6 +965,7 @@ namespace bnscup
 	{
 		m_nextScene = SceneKey::StageSelect;
 		m_step = Step::End;
+		saveReplay();
 		return;
 	}
 
@@ -1134,141 +973,404 @@ namespace bnscup
 	{
 		m_nextScene = SceneKey::StageSelect;
 		m_step = Step::End;
+		saveReplay();
 		return;
 	}
 
 	void GameScene::Impl::createUseKeyPopup()
 	{
-		auto* pMessageBox = new MessageBox(MessageBox::ButtonStyle::YesNo, MessageBox::ExistCrossButton::No, U"鍵を使用しますか？");
-		m_pMessageBox.reset(pMessageBox);
+		m_popups.push(PopupId::UseKey);
 		m_step = Step::UseKeyPopup;
 	}
 
 	void GameScene::Impl::createRescuePopup()
 	{
-		String message =
-			U"救助対象を見つけました！\n"
-			U"転送します。";
-		auto* pMessageBox = new MessageBox(MessageBox::ButtonStyle::OnlyOK, MessageBox::ExistCrossButton::No, message);
-		m_pMessageBox.reset(pMessageBox);
+		m_popups.push(PopupId::Rescue);
 		m_step = Step::RescuePopup;
 	}
 
 	void GameScene::Impl::createReturnPopup()
 	{
-		String exitMessage = U"";
-		size_t rescueCount = 0;
-		for (const auto& targetUnit : m_targetUnits)
+		m_popups.push(m_pSimulation->isAllRescued() ? PopupId::ReturnAllRescued : PopupId::ReturnNotAllRescued);
+		m_step = Step::ReturnPopup;
+	}
+
+	void GameScene::Impl::createNotHaveKeyPopup()
+	{
+		// お知らせだけなので止めずに並べる
+		m_popups.pushNotice(PopupId::NotHaveKey);
+		m_step = Step::Idle;
+	}
+
+	void GameScene::Impl::createCaughtPopup()
+	{
+		m_popups.push(PopupId::Caught);
+		m_step = Step::CaughtPopup;
+	}
+
+	void GameScene::Impl::applyCommand(GameSimulation::Command command)
+	{
+		// 救助で消える対象を先に確保しておく
+		const auto rescueCandidate = m_pSimulation->getRescueCandidate();
+
+		const auto result = m_pSimulation->step(command);
+		if (result != GameSimulation::TurnResult::Rejected)
+		{
+			m_replay.record(command);
+		}
+
+		switch (result)
+		{
+		case GameSimulation::TurnResult::Moved:
+		case GameSimulation::TurnResult::Bumped:
+			startTurn();
+			m_step = Step::Move;
+			break;
+		case GameSimulation::TurnResult::AskUnlock:
+			createUseKeyPopup();
+			break;
+		case GameSimulation::TurnResult::NoKey:
+			createNotHaveKeyPopup();
+			break;
+		case GameSimulation::TurnResult::AskEscape:
+			createReturnPopup();
+			break;
+		case GameSimulation::TurnResult::Unlocked:
+			m_step = Step::Idle;
+			break;
+		case GameSimulation::TurnResult::Rescued:
 		{
-			if (targetUnit.rescued)
+			DEBUG_BREAK(not(rescueCandidate.has_value()));
+			const auto& targetUnit = m_rescueTargetUnits[rescueCandidate.value_or(0)];
+			m_units.setEnable(targetUnit, false);
+			m_teleportAnim.setPos(m_units.getPos(targetUnit));
+			m_teleportAnim.reset();
+			m_teleportAnim.setEnable(true);
+			m_particles.emit(m_teleportEmitter, m_units.getPos(targetUnit));
+			m_step = Step::RescueAnim;
+			break;
+		}
+		case GameSimulation::TurnResult::Escaped:
+			m_teleportAnim.setPos(m_units.getPos(m_playerUnit));
+			m_teleportAnim.reset();
+			m_teleportAnim.setEnable(true);
+			m_particles.emit(m_teleportEmitter, m_units.getPos(m_playerUnit));
+			m_units.destroy(m_playerUnit);
+			m_step = Step::ReturnAnim;
+			break;
+		case GameSimulation::TurnResult::Cancelled:
+			m_step = Step::Idle;
+			break;
+		case GameSimulation::TurnResult::Undone:
+		case GameSimulation::TurnResult::Redone:
+			syncPresentation();
+			m_step = Step::Idle;
+			break;
+		case GameSimulation::TurnResult::Blocked:
+		case GameSimulation::TurnResult::Rejected:
+		default:
+			break;
+		}
+	}
+
+	void GameScene::Impl::pushControlButtonInputs()
+	{
+		// m_controlButtons の順
+		static const InputAction ACTION_TABLE[] = {
+			InputAction::Up,
+			InputAction::Down,
+			InputAction::Left,
+			InputAction::Right,
+		};
+		for (size_t i : step(std::size(m_controlButtons)))
+		{
+			if (m_controlButtons[i].isPressed(Button::Sounds::Select))
 			{
-				rescueCount++;
+				m_inputQueue.push(ACTION_TABLE[i]);
 			}
 		}
-		MessageBox* pMessageBox = nullptr;
-		if (rescueCount != m_targetUnits.size())
+	}
+
+	bool GameScene::Impl::applyMoveInput(const InputEvent& inputEvent)
+	{
+		const auto route = RouteFromInputAction(inputEvent.action);
+		if (route == RoomData::Route::Left)
+		{
+			m_units.setMirror(m_playerUnit, true);
+		}
+		else if (route == RoomData::Route::Right)
 		{
-			exitMessage =
-				U"まだ助けていないユニットがいます。\n"
-				U"脱出しますか？";
-			pMessageBox = new MessageBox(MessageBox::ButtonStyle::YesNo, MessageBox::ExistCrossButton::No, exitMessage);
+			m_units.setMirror(m_playerUnit, false);
 		}
-		else
+		applyCommand(GameSimulation::CommandFromRoute(route));
+		if (m_step != Step::Move)
 		{
-			exitMessage =
-				U"すべてのユニットを救助しました！\n"
-				U"脱出します。";
-			pMessageBox = new MessageBox(MessageBox::ButtonStyle::OnlyOK, MessageBox::ExistCrossButton::No, exitMessage);
+			return false;
 		}
-		DEBUG_BREAK(pMessageBox == nullptr);
-		m_pMessageBox.reset(pMessageBox);
-		m_step = Step::ReturnPopup;
+		m_inputQueue.recordDelay(inputEvent);
+		return true;
 	}
 
-	void GameScene::Impl::createNotHaveKeyPopup()
+	void GameScene::Impl::bufferMoveInputs()
 	{
-		String message =
-			U"鍵がかかっています。\n"
-			U"どこかに落ちている鍵を探しましょう！";
-		auto* pMessageBox = new MessageBox(MessageBox::ButtonStyle::OnlyOK, MessageBox::ExistCrossButton::No, message);
-		m_pMessageBox.reset(pMessageBox);
-		m_step = Step::CommonPopup;
+		InputEvent inputEvent{};
+		while (m_inputQueue.pop(inputEvent))
+		{
+			// あふれた分は捨てる（押しすぎて止まらなくなるのを防ぐ）
+			if (MOVE_BUFFER_CAPACITY <= m_bufferedMoves.size())
+			{
+				break;
+			}
+			m_bufferedMoves.push_back(inputEvent);
+		}
 	}
 
-	void GameScene::Impl::enemyMove()
+	void GameScene::Impl::startTurn()
 	{
-		for (auto& pEnemy : m_enemies)
+		const Vec2 playerTargetPos = MapPosToGlobalPos(m_pSimulation->getPlayerPos());
+		if (playerTargetPos != m_units.getPos(m_playerUnit))
+		{
+			m_units.setTargetPos(m_playerUnit, playerTargetPos);
+		}
+
+		const auto& enemies = m_pSimulation->getEnemies();
+		for (size_t i : step(enemies.size()))
 		{
-			if (pEnemy == nullptr)
+			const auto& enemyUnit = m_enemyUnits[i];
+			const Vec2 targetPos = MapPosToGlobalPos(enemies[i].pos);
+			const Vec2& enemyPos = m_units.getPos(enemyUnit);
+			if (targetPos.x < enemyPos.x)
 			{
-				continue;
+				m_units.setMirror(enemyUnit, true);
 			}
-			checkEnemyMoveDir(pEnemy);
-			Point enemyPos = MapPosFromGlobalPos(pEnemy->getPos());
-			switch (pEnemy->getMoveDirection())
+			else if (targetPos.x > enemyPos.x)
+			{
+				m_units.setMirror(enemyUnit, false);
+			}
+			m_units.setTargetPos(enemyUnit, targetPos);
+		}
+	}
+
+	void GameScene::Impl::onTurnSettled()
+	{
+		switch (m_pSimulation->getPhase())
+		{
+		case GameSimulation::Phase::Caught:
+			createCaughtPopup();
+			break;
+		case GameSimulation::Phase::ConfirmRescue:
+			createRescuePopup();
+			break;
+		case GameSimulation::Phase::ConfirmEscape:
+			createReturnPopup();
+			break;
+		case GameSimulation::Phase::Escaped:
+			m_step = Step::Result;
+			break;
+		case GameSimulation::Phase::Idle:
+		default:
+			m_step = Step::Idle;
+			break;
+		}
+	}
+
+	void GameScene::Impl::syncPresentation()
+	{
+		if (m_units.isAlive(m_playerUnit))
+		{
+			m_units.setPos(m_playerUnit, MapPosToGlobalPos(m_pSimulation->getPlayerPos()));
+			m_camera.setCenter(m_units.getPos(m_playerUnit));
+			if (m_pSimulation->getPhase() == GameSimulation::Phase::Escaped)
 			{
-			case RoomData::Route::Up: enemyPos.y -= 1; break;
-			case RoomData::Route::Right: enemyPos.x += 1; break;
-			case RoomData::Route::Down: enemyPos.y += 1; break;
-			case RoomData::Route::Left: enemyPos.x -= 1; break;
-			default: DEBUG_BREAK(true); break;
+				m_units.setEnable(m_playerUnit, false);
 			}
-			pEnemy->setTargetPos(MapPosToGlobalPos(enemyPos));
 		}
+
+		const auto& enemies = m_pSimulation->getEnemies();
+		for (size_t i : step(enemies.size()))
+		{
+			m_units.setPos(m_enemyUnits[i], MapPosToGlobalPos(enemies[i].pos));
+			m_units.setMirror(m_enemyUnits[i], enemies[i].moveDirection == RoomData::Route::Left);
+		}
+
+		const auto& rescueTargets = m_pSimulation->getRescueTargets();
+		for (size_t i : step(rescueTargets.size()))
+		{
+			m_units.setEnable(m_rescueTargetUnits[i], not(rescueTargets[i].isRescued));
+		}
+
+		// 戻した場合は拾った鍵も元に戻る
+		const auto& keys = m_pSimulation->getKeys();
+		for (size_t i : step(keys.size()))
+		{
+			m_items.setOwner(i, keys[i].isHeld ? m_playerUnit : UnitHandle{});
+		}
+	}
+
+	void GameScene::Impl::updateUnits()
+	{
+		// 次の手が溜まっている間は続けて見せるために速く動かす
+		const double unitDeltaTime = m_bufferedMoves.isEmpty() ? m_deltaTime : (m_deltaTime * CHAINED_MOVE_SPEED_SCALE);
+		for (int32 i = 0; i < m_stepCount; ++i)
+		{
+			m_units.beginStep();
+			m_units.update(unitDeltaTime);
+		}
+		m_unitAlpha = m_pTimestep->getAlpha();
+	}
+
+	void GameScene::Impl::buildSpriteDrawList()
+	{
+		m_spriteDrawList.clear();
+		m_items.addSprites(m_spriteDrawList);
+		m_units.addSprites(m_spriteDrawList, m_unitAlpha);
+		m_spriteDrawList.sort();
 	}
 
-	void GameScene::Impl::checkEnemyMoveDir(Enemy* pEnemy)
+	void GameScene::Impl::dispatchEvents()
 	{
-		if (pEnemy == nullptr)
+		// 移動の演出中は溜めておき、着いてからまとめて反映する
+		if (m_step == Step::Move or m_events.isEmpty())
 		{
 			return;
 		}
-		Point enemyPos = MapPosFromGlobalPos(pEnemy->getPos());
-		const auto& roomData = m_pMapData->getRoomData(enemyPos);
-		const auto& moveDirection = pEnemy->getMoveDirection();
-		if (not(roomData.canPassable(moveDirection))
-			|| roomData.isLocked(moveDirection))
+
+		bool isKeyCollected = false;
+		bool isDoorUnlocked = false;
+		for (const auto& event : m_events.getEvents())
 		{
-			if (pEnemy->getMoveType() == Enemy::MoveType::UpDown)
+			switch (event.type)
 			{
-				if (moveDirection == RoomData::Route::Up)
-				{
-					pEnemy->setMoveDirection(RoomData::Route::Down);
-				}
-				else
-				{
-					pEnemy->setMoveDirection(RoomData::Route::Up);
-				}
+			case GameEventType::KeyCollected:
+				m_items.setOwner(static_cast<size_t>(event.index), m_playerUnit);
+				m_particles.emit(m_keyPickupEmitter, MapPosToGlobalPos(event.pos));
+				isKeyCollected = true;
+				break;
+			case GameEventType::DoorUnlocked:
+			{
+				// 扉は部屋の中心から2マス先
+				const Point offset = RoomData::GetRouteOffset(ToEnum<RoomData::Route>(static_cast<uint8>(event.index)));
+				m_particles.emit(m_doorUnlockEmitter, MapPosToGlobalPos(event.pos) + Vec2{ offset.x * 32.0, offset.y * 32.0 });
+				isDoorUnlocked = true;
+				break;
+			}
+			default:
+				break;
 			}
-			else if (pEnemy->getMoveType() == Enemy::MoveType::LeftRight)
+
+			// 集計
+			m_eventCounts[FromEnum(event.type)]++;
+		}
+
+		// 同じフレームに重なっても音は1回だけ
+		if (isKeyCollected)
+		{
+			SoundManager::Play(m_collectItemSE);
+		}
+		if (isDoorUnlocked)
+		{
+			SoundManager::Play(m_unlockDoorSE);
+		}
+
+		m_events.clear();
+	}
+
+	bool GameScene::Impl::updatePlayback()
+	{
+		// 入力待ちのステップでのみコマンドを流し込む
+		if (not(isPlaybackInputStep()))
+		{
+			return false;
+		}
+
+		if (m_playbackReplay.getCommandCount() <= m_playbackIndex)
+		{
+			// 再生終わり、以降は通常の操作
+			m_isPlayback = false;
+			m_playbackSpeed = 1.0;
+			return false;
+		}
+
+		updateUnits();
+
+		// 溜まった時間の分だけ流す（余りは次のフレームに持ち越す）
+		m_playbackTimer += m_frameTime;
+		for (int32 i = 0; i < MAX_REPLAY_COMMANDS_PER_FRAME; ++i)
+		{
+			if (m_playbackTimer < REPLAY_COMMAND_INTERVAL
+				or m_playbackReplay.getCommandCount() <= m_playbackIndex)
 			{
-				if (moveDirection == RoomData::Route::Left)
-				{
-					pEnemy->setMoveDirection(RoomData::Route::Right);
-					pEnemy->setMirror(false);
-				}
-				else
-				{
-					pEnemy->setMoveDirection(RoomData::Route::Left);
-					pEnemy->setMirror(true);
-				}
+				break;
+			}
+			m_playbackTimer -= REPLAY_COMMAND_INTERVAL;
+
+			m_popups.clear();
+			applyCommand(m_playbackReplay.getCommand(m_playbackIndex));
+			m_playbackIndex++;
+
+			// 演出が始まったら終わるまで次を流さない
+			if (not(isPlaybackInputStep()))
+			{
+				break;
 			}
-			DEBUG_BREAK(not(roomData.canPassable(pEnemy->getMoveDirection())));
-			DEBUG_BREAK(roomData.isLocked(pEnemy->getMoveDirection()));
 		}
+		return true;
 	}
-	
+
+	bool GameScene::Impl::isPlaybackInputStep() const
+	{
+		return (m_step == Step::Idle)
+			or (m_step == Step::UseKeyPopup)
+			or (m_step == Step::RescuePopup)
+			or (m_step == Step::ReturnPopup)
+			or (m_step == Step::CaughtPopup);
+	}
+
+	void GameScene::Impl::saveReplay() const
+	{
+		if (m_replay.isEmpty())
+		{
+			return;
+		}
+		const FilePath path = U"replay/{}.replay"_fmt(DateTime::Now().format(U"yyyyMMdd_HHmmss"));
+		if (not(m_replay.save(path)))
+		{
+			DEBUG_BREAK(true);
+		}
+	}
+
 	//==================================================
 
 	GameScene::GameScene(const super::InitData& init)
 		: super{ init }
+		, m_arenaScope{ getData().pSceneArena }
 		, m_pImpl{ nullptr }
+		, m_constructAllocCount{ 0 }
 	{
-		m_pImpl.reset(new Impl(getData().stageNo));
+		auto& sceneData = getData();
+		if (sceneData.pSceneArena == nullptr
+			or sceneData.pTimestep == nullptr)
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		const size_t allocCount = HeapCounter::GetAllocCount();
+		m_pImpl = sceneData.pSceneArena->create<Impl>(sceneData.stageNo, sceneData.pReplayPlayback, sceneData.pSceneArena, sceneData.pTimestep);
+		m_constructAllocCount = HeapCounter::GetAllocCount() - allocCount;
+		// リプレイは1回だけ再生する
+		sceneData.pReplayPlayback = nullptr;
 	}
 
 	GameScene::~GameScene()
 	{
+#ifdef _DEBUG
+		// 2回目以降のステージで arena の block と heap の回数が増えていなければ、シーンの出入りで一般ヒープを使っていない
+		// （テクスチャなど Siv3D が operator new を通さずに確保するものは数えない）
+		const String stats = m_pImpl ? m_pImpl->formatStats() : String{};
+		const size_t allocCount = HeapCounter::GetAllocCount();
+		m_pImpl.reset();
+		Logger << U"scene: {}, heap alloc: construct {}, teardown {}"_fmt(stats, m_constructAllocCount, HeapCounter::GetAllocCount() - allocCount);
+#endif // _DEBUG
 	}
 
 	void GameScene::update()
@@ -3,6 +3,7 @@
 #define BNSCUP_GAMESCENE_H_
 
 #include "../SceneDefine.h"
+#include "../../Memory/SceneArena.h"
 
 namespace bnscup
 {
@@ -20,7 +21,10 @@ namespace bnscup
 	private:
 
 		class Impl;
-		std::unique_ptr<Impl> m_pImpl;
+		// 先に宣言し、Impl の破棄が終わってからアリーナを巻き戻す
+		SceneArena::Scope m_arenaScope;
+		ArenaPtr<Impl> m_pImpl;
+		size_t m_constructAllocCount;	// Impl を作る間の一般ヒープの確保回数（デバッグビルドのみ数える）
 	};
 }
 
@@ -106,32 +106,42 @@ namespace bnscup
 					m_tileSet(srcRect2).draw((x * 5 + 4) * chipSize, (y * 5 + 1) * chipSize);
 					m_tileSet(srcRect3).draw((x * 5 + 4) * chipSize, (y * 5 + 3) * chipSize);
 				}
-				// 扉の表示
+				// 扉の表示（開けられる鍵の色で塗る）
 				if (room.isLocked(RoomData::Route::Up))
 				{
 					RectF srcRect{ 7 * chipSize, 3 * chipSize, chipSize, chipSize };
-					m_tileSet(srcRect).draw((x * 5 + 2) * chipSize, (y * 5 + 0) * chipSize);
+					m_tileSet(srcRect).draw((x * 5 + 2) * chipSize, (y * 5 + 0) * chipSize, GetKeyColorTint(room.getLockColor(RoomData::Route::Up)));
 				}
 				if (room.isLocked(RoomData::Route::Down))
 				{
 					RectF srcRect{ 7 * chipSize, 3 * chipSize, chipSize, chipSize };
-					m_tileSet(srcRect).draw((x * 5 + 2) * chipSize, (y * 5 + 4) * chipSize);
+					m_tileSet(srcRect).draw((x * 5 + 2) * chipSize, (y * 5 + 4) * chipSize, GetKeyColorTint(room.getLockColor(RoomData::Route::Down)));
 				}
 				if (room.isLocked(RoomData::Route::Left))
 				{
 					RectF srcRect{ 7 * chipSize, 4 * chipSize, chipSize, chipSize };
-					m_tileSet(srcRect).draw((x * 5 + 0) * chipSize, (y * 5 + 2) * chipSize);
+					m_tileSet(srcRect).draw((x * 5 + 0) * chipSize, (y * 5 + 2) * chipSize, GetKeyColorTint(room.getLockColor(RoomData::Route::Left)));
 				}
 				if (room.isLocked(RoomData::Route::Right))
 				{
 					RectF srcRect{ 8 * chipSize, 5 * chipSize, chipSize, chipSize };
-					m_tileSet(srcRect).draw((x * 5 + 4) * chipSize, (y * 5 + 2) * chipSize);
+					m_tileSet(srcRect).draw((x * 5 + 4) * chipSize, (y * 5 + 2) * chipSize, GetKeyColorTint(room.getLockColor(RoomData::Route::Right)));
 				}
 			}
 		}
 
 	}
 
+	ColorF MapView::GetKeyColorTint(RoomData::KeyColor color)
+	{
+		switch (color)
+		{
+		case RoomData::KeyColor::Silver:	return ColorF{ 0.75, 0.85, 1.0 };
+		case RoomData::KeyColor::Copper:	return ColorF{ 1.0, 0.6, 0.45 };
+		default:							return ColorF{ 1.0 };
+		}
+	}
+
 	void MapView::createDisp()
 	{
 		if (m_pMapData == nullptr)
@@ -3,6 +3,7 @@
 #define BNSCUP_MAPVIEW_H_
 
 #include <Siv3D.hpp>
+#include "RoomData.h"
 
 namespace bnscup
 {
@@ -16,6 +17,9 @@ namespace bnscup
 
 		void draw() const;
 
+		// 鍵と扉を色分けするときの乗算色（金は元の絵のまま）
+		static ColorF GetKeyColorTint(RoomData::KeyColor color);
+
 	private:
 
 		void createDisp();
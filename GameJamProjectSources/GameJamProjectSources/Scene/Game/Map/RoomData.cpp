@@ -2,10 +2,31 @@
 
 namespace bnscup
 {
-	RoomData::RoomData(uint8 route, uint8 lock)
+	namespace
+	{
+		// 4bit ごとに並べた扉の色のうち、その向きの位置
+		uint16 LockColorShift(RoomData::Route route)
+		{
+			switch (route)
+			{
+			case RoomData::Route::Up:		return 0;
+			case RoomData::Route::Right:	return 4;
+			case RoomData::Route::Down:		return 8;
+			case RoomData::Route::Left:		return 12;
+			default:						return 16;
+			}
+		}
+
+		constexpr uint16 LOCK_COLOR_MASK = 0xF;
+	}
+
+	RoomData::RoomData(uint8 route, uint8 lock, KeyColor lockColor)
 		: m_route{ route }
 		, m_routeLock{ lock }
+		, m_lockColors{ 0 }
 	{
+		const uint16 color = FromEnum(lockColor);
+		m_lockColors = static_cast<uint16>(color | (color << 4) | (color << 8) | (color << 12));
 	}
 
 	RoomData::~RoomData()
@@ -27,10 +48,69 @@ namespace bnscup
 		return m_routeLock & FromEnum(route);
 	}
 
+	void RoomData::setLockColor(Route route, KeyColor color)
+	{
+		const uint16 shift = LockColorShift(route);
+		if (16 <= shift)
+		{
+			return;
+		}
+		m_lockColors = static_cast<uint16>((m_lockColors & ~(LOCK_COLOR_MASK << shift)) | (FromEnum(color) << shift));
+	}
+
+	RoomData::KeyColor RoomData::getLockColor(Route route) const
+	{
+		const uint16 shift = LockColorShift(route);
+		if (16 <= shift)
+		{
+			return KeyColor::None;
+		}
+		return ToEnum<KeyColor>(static_cast<uint8>((m_lockColors >> shift) & LOCK_COLOR_MASK));
+	}
+
+	bool RoomData::canUnlock(Route route, uint8 keyColorBits) const
+	{
+		return (FromEnum(getLockColor(route)) & keyColorBits) != 0;
+	}
+
 	bool RoomData::isEmpty() const
 	{
 		return m_route == FromEnum(Route::None);
 	}
 
+	uint8 RoomData::getLockBits() const
+	{
+		return m_routeLock;
+	}
+
+	void RoomData::setLockBits(uint8 lock)
+	{
+		m_routeLock = lock;
+	}
+
+	RoomData::Route RoomData::GetReverseRoute(Route route)
+	{
+		switch (route)
+		{
+		case Route::Up:		return Route::Down;
+		case Route::Right:	return Route::Left;
+		case Route::Down:	return Route::Up;
+		case Route::Left:	return Route::Right;
+		default:			return Route::None;
+		}
+	}
+
+	Point RoomData::GetRouteOffset(Route route)
+	{
+		switch (route)
+		{
+		case Route::Up:		return Point{  0, -1 };
+		case Route::Right:	return Point{  1,  0 };
+		case Route::Down:	return Point{  0,  1 };
+		case Route::Left:	return Point{ -1,  0 };
+		default:			return Point{  0,  0 };
+		}
+	}
+
 }
 
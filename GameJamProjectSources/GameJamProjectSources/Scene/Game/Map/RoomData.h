@@ -31,9 +31,20 @@ namespace bnscup
 			RightDownLeft = Right | Down | Left,
 		};
 
+		// 鍵と扉の色。所持している鍵は色のビットの和で持つ
+		enum class KeyColor : uint8
+		{
+			None   = 0,
+			Gold   = 1 << 0,
+			Silver = 1 << 1,
+			Copper = 1 << 2,
+
+			All = Gold | Silver | Copper,
+		};
+
 	public:
 
-		explicit RoomData(uint8 route, uint8 lock);
+		explicit RoomData(uint8 route, uint8 lock, KeyColor lockColor = KeyColor::Gold);
 		virtual ~RoomData();
 
 		void unlock(Route route);
@@ -41,10 +52,23 @@ namespace bnscup
 		bool isLocked(Route route) const;
 		bool isEmpty() const;
 
+		// 扉ごとの色（鍵がかかっていない向きの色は使わない）
+		void setLockColor(Route route, KeyColor color);
+		KeyColor getLockColor(Route route) const;
+		// 持っている鍵の色で開けられるか
+		bool canUnlock(Route route, uint8 keyColorBits) const;
+
+		uint8 getLockBits() const;
+		void setLockBits(uint8 lock);
+
+		static Route GetReverseRoute(Route route);
+		static Point GetRouteOffset(Route route);
+
 	private:
 
 		uint8 m_route;
 		uint8 m_routeLock;
+		uint16 m_lockColors;	// 向きごとに4bitずつ色のビットを持つ（変化しないので履歴には含めない）
 	};
 }
 
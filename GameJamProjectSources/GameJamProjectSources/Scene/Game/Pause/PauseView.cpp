@@ -1,6 +1,8 @@
 ﻿#include "PauseView.h"
 #include "../../../Common/Common.h"
 #include "../../../Button/Button.h"
+#include "../../../Text/TextLayout.h"
+#include "../../../Text/TextTable.h"
 
 namespace
 {
@@ -16,6 +18,14 @@ namespace
 
 	static const SizeF SIZE_VIEWAREA{ 600, 600 };
 	static const SizeF SIZE_BUTTON{ 300, 100 };
+
+	static const bnscup::TextId BUTTON_TEXT_TABLE[] =
+	{
+		bnscup::TextId::PauseReturnStageSelect,
+		bnscup::TextId::PauseReturnTitle,
+		bnscup::TextId::PauseClose,
+	};
+	static_assert(std::size(BUTTON_TEXT_TABLE) == PauseViewButtonCount);
 }
 
 namespace bnscup
@@ -24,8 +34,11 @@ namespace bnscup
 		: m_isEnable{ true }
 		, m_textFont{}
 		, m_buttonFont{}
+		, m_pTitleLayout{ nullptr }
+		, m_pButtonLayouts{}
 		, m_viewArea{ Arg::center(Scene::CenterF()), SIZE_VIEWAREA, 10 }
 		, m_pButtons{}
+		, m_layer{ m_viewArea.rect.stretched(20).asRect() }	// 影の分だけ広げる
 	{
 		const double buttonMargin = 10.0;
 		for(int32 i : step(PauseViewButtonCount))
@@ -37,6 +50,16 @@ namespace bnscup
 		}
 		m_textFont = FontAsset(U"font_pause_view");
 		m_buttonFont = FontAsset(U"font_button");
+
+		// 文字は変わらないので並べた結果を使い回す
+		m_pTitleLayout = TextLayoutCache::Get(m_textFont, TextTable::Get(TextId::PauseTitle));
+		for (const auto textId : BUTTON_TEXT_TABLE)
+		{
+			m_pButtonLayouts.push_back(TextLayoutCache::Get(m_buttonFont, TextTable::Get(textId)));
+		}
+
+		// ボタンの見た目は変わらないので一度だけ描いておく
+		m_layer.refresh([this]() { drawLayer(); });
 	}
 
 	PauseView::~PauseView()
@@ -64,12 +87,17 @@ namespace bnscup
 		{
 			return;
 		}
+		m_layer.draw();
+	}
+
+	void PauseView::drawLayer() const
+	{
 		m_viewArea
 			.drawShadow(Vec2{ 3, 3 }, 10)
 			.draw(Palette::Steelblue)
 			.drawFrame(1.0, Palette::Black);
 
-		m_textFont(U"ポーズ").drawAt(m_viewArea.center() - Vec2{ 0.0, m_viewArea.h * 0.25 }, Palette::Black);
+		m_pTitleLayout->drawAt(m_viewArea.center() - Vec2{ 0.0, m_viewArea.h * 0.25 }, Palette::Black);
 
 		// ステージ選択画面へボタン
 		{
@@ -81,7 +109,7 @@ namespace bnscup
 					.drawShadow(Vec2{ 2, 2 }, 5)
 					.draw(Palette::Darkolivegreen)
 					.drawFrame(1.0, Palette::Black);
-				m_buttonFont(U"ステージ選択へ").drawAt(buttonRect.center(), Palette::Black);
+				m_pButtonLayouts[FromEnum(PauseViewButton::ReturnStageSelect)]->drawAt(buttonRect.center(), Palette::Black);
 			}
 		}
 		// タイトル画面へボタン
@@ -94,7 +122,7 @@ namespace bnscup
 					.drawShadow(Vec2{ 2, 2 }, 5)
 					.draw(Palette::Darkolivegreen)
 					.drawFrame(1.0, Palette::Black);
-				m_buttonFont(U"タイトルへ").drawAt(buttonRect.center(), Palette::Black);
+				m_pButtonLayouts[FromEnum(PauseViewButton::ReturnTitle)]->drawAt(buttonRect.center(), Palette::Black);
 			}
 		}
 		// 閉じるボタン
@@ -107,7 +135,7 @@ namespace bnscup
 					.drawShadow(Vec2{ 2, 2 }, 5)
 					.draw(Palette::Saddlebrown)
 					.drawFrame(1.0, Palette::Black);
-				m_buttonFont(U"閉じる").drawAt(buttonRect.center(), Palette::Black);
+				m_pButtonLayouts[FromEnum(PauseViewButton::Close)]->drawAt(buttonRect.center(), Palette::Black);
 			}
 		}
 	}
@@ -3,10 +3,12 @@
 #define BNSCUP_PAUSEVIEW_H_
 
 #include <Siv3D.hpp>
+#include "../../../RetainedLayer/RetainedLayer.h"
 
 namespace bnscup
 {
 	class Button;
+	class TextLayout;
 
 	class PauseView
 	{
@@ -29,13 +31,19 @@ namespace bnscup
 
 		const Button* getButton(int32 index) const;
 
+		// 層に描く中身（ボタンの見た目が変わったときだけ呼ぶ）
+		void drawLayer() const;
+
 	private:
 
 		bool m_isEnable;
 		Font m_textFont;
 		Font m_buttonFont;
+		const TextLayout* m_pTitleLayout;
+		Array<const TextLayout*> m_pButtonLayouts;
 		RoundRect m_viewArea;
 		Array<std::unique_ptr<Button>> m_pButtons;
+		RetainedLayer m_layer;
 	};
 }
 
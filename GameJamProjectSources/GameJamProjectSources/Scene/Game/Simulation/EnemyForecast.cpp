@@ -0,0 +1,180 @@
+﻿#include "EnemyForecast.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// 危険表の上限（手数 x 部屋数）
+		constexpr size_t DANGER_TABLE_MAX_SIZE = 1 << 20;
+
+		size_t GreatestCommonDivisor(size_t a, size_t b)
+		{
+			while (b != 0)
+			{
+				const size_t r = a % b;
+				a = b;
+				b = r;
+			}
+			return a;
+		}
+	}
+
+	EnemyForecast::EnemyForecast()
+		: m_mapSize{ Size::Zero() }
+		, m_baseTurn{ 0 }
+		, m_trajectories{}
+		, m_dangerTable{}
+		, m_dangerPrefix{ 0 }
+		, m_dangerPeriod{ 0 }
+	{
+	}
+
+	EnemyForecast::~EnemyForecast()
+	{
+	}
+
+	void EnemyForecast::reset(const Size& mapSize, uint32 baseTurn, size_t enemyCount)
+	{
+		m_mapSize = mapSize;
+		m_baseTurn = baseTurn;
+		m_trajectories.resize(enemyCount);
+		for (auto& trajectory : m_trajectories)
+		{
+			trajectory.samples.clear();
+			trajectory.cycleStart = 0;
+		}
+		m_dangerTable.clear();
+		m_dangerPrefix = 0;
+		m_dangerPeriod = 0;
+	}
+
+	void EnemyForecast::setTrajectory(size_t enemyIndex, const Array<Sample>& samples, size_t cycleStart)
+	{
+		DEBUG_BREAK(samples.size() <= cycleStart);
+		auto& trajectory = m_trajectories[enemyIndex];
+		trajectory.samples = samples;
+		trajectory.cycleStart = cycleStart;
+	}
+
+	void EnemyForecast::finalize()
+	{
+		m_dangerTable.clear();
+
+		// 全員がそろって周期に入る手と、全体の周期
+		size_t prefix = 0;
+		size_t period = 1;
+		for (const auto& trajectory : m_trajectories)
+		{
+			if (trajectory.samples.isEmpty())
+			{
+				continue;
+			}
+			const size_t cycleLength = trajectory.samples.size() - trajectory.cycleStart;
+			prefix = Max(prefix, trajectory.cycleStart);
+			period = period / GreatestCommonDivisor(period, cycleLength) * cycleLength;
+			if (DANGER_TABLE_MAX_SIZE < period)
+			{
+				return;
+			}
+		}
+
+		const size_t roomCount = static_cast<size_t>(m_mapSize.x * m_mapSize.y);
+		const size_t turnCount = prefix + period;
+		if (DANGER_TABLE_MAX_SIZE < turnCount * roomCount)
+		{
+			return;
+		}
+
+		m_dangerPrefix = prefix;
+		m_dangerPeriod = period;
+		m_dangerTable.assign(turnCount * roomCount, 0);
+		for (size_t t = 0; t < turnCount; ++t)
+		{
+			uint8* row = m_dangerTable.data() + t * roomCount;
+			for (const auto& trajectory : m_trajectories)
+			{
+				if (trajectory.samples.isEmpty())
+				{
+					continue;
+				}
+				const auto& pos = trajectory.samples[getSampleIndex(trajectory, m_baseTurn + static_cast<uint32>(t))].pos;
+				row[pos.y * m_mapSize.x + pos.x] = 1;
+			}
+		}
+	}
+
+	uint32 EnemyForecast::getBaseTurn() const
+	{
+		return m_baseTurn;
+	}
+
+	bool EnemyForecast::isPredictable(size_t enemyIndex) const
+	{
+		return (enemyIndex < m_trajectories.size())
+			and not(m_trajectories[enemyIndex].samples.isEmpty());
+	}
+
+	size_t EnemyForecast::getPeriod(size_t enemyIndex) const
+	{
+		if (not(isPredictable(enemyIndex)))
+		{
+			return 0;
+		}
+		const auto& trajectory = m_trajectories[enemyIndex];
+		return trajectory.samples.size() - trajectory.cycleStart;
+	}
+
+	Optional<EnemyForecast::Sample> EnemyForecast::getSample(size_t enemyIndex, uint32 turn) const
+	{
+		if (not(isPredictable(enemyIndex)) or turn < m_baseTurn)
+		{
+			return none;
+		}
+		const auto& trajectory = m_trajectories[enemyIndex];
+		return trajectory.samples[getSampleIndex(trajectory, turn)];
+	}
+
+	bool EnemyForecast::isDangerous(const Point& roomPos, uint32 turn) const
+	{
+		if (turn < m_baseTurn
+			or roomPos.x < 0 or m_mapSize.x <= roomPos.x
+			or roomPos.y < 0 or m_mapSize.y <= roomPos.y)
+		{
+			return false;
+		}
+
+		if (not(m_dangerTable.isEmpty()))
+		{
+			size_t t = turn - m_baseTurn;
+			if (m_dangerPrefix <= t)
+			{
+				t = m_dangerPrefix + (t - m_dangerPrefix) % m_dangerPeriod;
+			}
+			const size_t roomCount = static_cast<size_t>(m_mapSize.x * m_mapSize.y);
+			return (m_dangerTable[t * roomCount + roomPos.y * m_mapSize.x + roomPos.x] != 0);
+		}
+
+		// 危険表が大きすぎる場合は敵ごとに引く
+		for (const auto& trajectory : m_trajectories)
+		{
+			if (not(trajectory.samples.isEmpty())
+				and trajectory.samples[getSampleIndex(trajectory, turn)].pos == roomPos)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_t EnemyForecast::getSampleIndex(const Trajectory& trajectory, uint32 turn) const
+	{
+		const size_t t = turn - m_baseTurn;
+		if (t < trajectory.cycleStart)
+		{
+			return t;
+		}
+		const size_t cycleLength = trajectory.samples.size() - trajectory.cycleStart;
+		return trajectory.cycleStart + (t - trajectory.cycleStart) % cycleLength;
+	}
+}
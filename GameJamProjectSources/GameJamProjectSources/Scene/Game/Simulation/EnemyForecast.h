@@ -0,0 +1,72 @@
+﻿#pragma once
+#ifndef BNSCUP_ENEMYFORECAST_H_
+#define BNSCUP_ENEMYFORECAST_H_
+
+#include <Siv3D.hpp>
+#include "../Map/RoomData.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief プレイヤーに依存しない敵の先読み
+	 * @details 往復や巡回する敵の動きは地形だけで決まるので、いずれ同じ状態に戻る。
+	 *          周期に入るまでの手と1周期分の状態を一度だけ求めておき、
+	 *          任意の手数での位置と部屋の危険を計算せずに引く。
+	 *          地形（ロック）が変わったら作り直す。
+	 */
+	class EnemyForecast
+	{
+	public:
+
+		struct Sample
+		{
+			Point pos;
+			RoomData::Route moveDirection;
+		};
+
+	public:
+
+		EnemyForecast();
+		virtual ~EnemyForecast();
+
+		void reset(const Size& mapSize, uint32 baseTurn, size_t enemyCount);
+
+		// samples[i] が baseTurn + i 手目の状態、cycleStart 以降を繰り返す
+		void setTrajectory(size_t enemyIndex, const Array<Sample>& samples, size_t cycleStart);
+
+		// 全員の軌道を設定し終えたら呼ぶ（部屋ごとの危険表を作る）
+		void finalize();
+
+		uint32 getBaseTurn() const;
+		bool isPredictable(size_t enemyIndex) const;
+		size_t getPeriod(size_t enemyIndex) const;
+
+		Optional<Sample> getSample(size_t enemyIndex, uint32 turn) const;
+
+		// 先読みできる敵のいずれかが turn 手目に roomPos にいるか
+		bool isDangerous(const Point& roomPos, uint32 turn) const;
+
+	private:
+
+		struct Trajectory
+		{
+			Array<Sample> samples;
+			size_t cycleStart;
+		};
+
+		size_t getSampleIndex(const Trajectory& trajectory, uint32 turn) const;
+
+	private:
+
+		Size m_mapSize;
+		uint32 m_baseTurn;
+		Array<Trajectory> m_trajectories;
+
+		// 全員の周期の最小公倍数分の危険表（大きくなりすぎる場合は作らない）
+		Array<uint8> m_dangerTable;
+		size_t m_dangerPrefix;
+		size_t m_dangerPeriod;
+	};
+}
+
+#endif // !BNSCUP_ENEMYFORECAST_H_
@@ -0,0 +1,128 @@
+﻿#include "FlowField.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// 同じ距離の候補がある場合はこの順に選ぶ
+		static const RoomData::Route ROUTE_TABLE[] =
+		{
+			RoomData::Route::Up,
+			RoomData::Route::Right,
+			RoomData::Route::Down,
+			RoomData::Route::Left,
+		};
+	}
+
+	FlowField::FlowField()
+		: m_goal{ Point::Zero() }
+		, m_mapSize{ Size::Zero() }
+		, m_distances{}
+		, m_queue{}
+	{
+	}
+
+	FlowField::~FlowField()
+	{
+	}
+
+	void FlowField::build(const MapData& mapData, const Point& goal)
+	{
+		m_goal = goal;
+		m_mapSize = mapData.getMapSize();
+
+		const size_t roomCount = static_cast<size_t>(m_mapSize.x * m_mapSize.y);
+		m_distances.assign(roomCount, UNREACHABLE);
+		// キューは使い回す（部屋数より多く積まれることはない）
+		m_queue.resize(roomCount);
+
+		const int32 goalIndex = goal.y * m_mapSize.x + goal.x;
+		DEBUG_BREAK((goalIndex < 0 or roomCount <= static_cast<size_t>(goalIndex)));
+		m_distances[goalIndex] = 0;
+		m_queue[0] = goalIndex;
+
+		size_t head = 0;
+		size_t tail = 1;
+		while (head < tail)
+		{
+			const int32 index = m_queue[head++];
+			const Point pos{ index % m_mapSize.x, index / m_mapSize.x };
+			const uint16 nextDistance = static_cast<uint16>(m_distances[index] + 1);
+			for (const auto route : ROUTE_TABLE)
+			{
+				if (not(CanMove(mapData, pos, route)))
+				{
+					continue;
+				}
+				const Point nextPos = pos + RoomData::GetRouteOffset(route);
+				const int32 nextIndex = nextPos.y * m_mapSize.x + nextPos.x;
+				if (m_distances[nextIndex] != UNREACHABLE)
+				{
+					continue;
+				}
+				m_distances[nextIndex] = nextDistance;
+				m_queue[tail++] = nextIndex;
+			}
+		}
+	}
+
+	bool FlowField::isBuilt() const
+	{
+		return not(m_distances.isEmpty());
+	}
+
+	const Point& FlowField::getGoal() const
+	{
+		return m_goal;
+	}
+
+	uint16 FlowField::getDistance(const Point& pos) const
+	{
+		if (pos.x < 0 or m_mapSize.x <= pos.x
+			or pos.y < 0 or m_mapSize.y <= pos.y
+			or not(isBuilt()))
+		{
+			return UNREACHABLE;
+		}
+		return m_distances[pos.y * m_mapSize.x + pos.x];
+	}
+
+	RoomData::Route FlowField::getNextRoute(const MapData& mapData, const Point& pos) const
+	{
+		const uint16 distance = getDistance(pos);
+		if (distance == 0 or distance == UNREACHABLE)
+		{
+			return RoomData::Route::None;
+		}
+		for (const auto route : ROUTE_TABLE)
+		{
+			if (CanMove(mapData, pos, route)
+				and getDistance(pos + RoomData::GetRouteOffset(route)) < distance)
+			{
+				return route;
+			}
+		}
+		DEBUG_BREAK(true); // 距離が求まっているなら必ず近づける
+		return RoomData::Route::None;
+	}
+
+	bool FlowField::CanMove(const MapData& mapData, const Point& pos, RoomData::Route route)
+	{
+		const auto& room = mapData.getRoomData(pos);
+		if (not(room.canPassable(route)) or room.isLocked(route))
+		{
+			return false;
+		}
+		const Point nextPos = pos + RoomData::GetRouteOffset(route);
+		const auto& mapSize = mapData.getMapSize();
+		if (nextPos.x < 0 or mapSize.x <= nextPos.x
+			or nextPos.y < 0 or mapSize.y <= nextPos.y)
+		{
+			return false;
+		}
+		const auto reverseRoute = RoomData::GetReverseRoute(route);
+		const auto& nextRoom = mapData.getRoomData(nextPos);
+		return nextRoom.canPassable(reverseRoute) and not(nextRoom.isLocked(reverseRoute));
+	}
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#ifndef BNSCUP_FLOWFIELD_H_
+#define BNSCUP_FLOWFIELD_H_
+
+#include <Siv3D.hpp>
+#include "../Map/MapData.h"
+#include "../Map/RoomData.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 目的の部屋までの距離マップ（部屋単位の幅優先探索）
+	 * @details 通路は両側から通れて鍵がかかっていない場合のみつながっているとみなす。
+	 *          通路は対称なので、目的の部屋から広げた距離がそのまま各部屋からの距離になる。
+	 *          目的地が同じ敵は何体いても1つの距離マップを共有できる。
+	 */
+	class FlowField
+	{
+	public:
+
+		static constexpr uint16 UNREACHABLE = 0xFFFF;
+
+	public:
+
+		FlowField();
+		virtual ~FlowField();
+
+		void build(const MapData& mapData, const Point& goal);
+
+		bool isBuilt() const;
+		const Point& getGoal() const;
+
+		// 目的の部屋までの手数（たどり着けない場合は UNREACHABLE）
+		uint16 getDistance(const Point& pos) const;
+
+		// 目的の部屋へ1手近づく向き（到着済み、たどり着けない場合は None）
+		RoomData::Route getNextRoute(const MapData& mapData, const Point& pos) const;
+
+		static bool CanMove(const MapData& mapData, const Point& pos, RoomData::Route route);
+
+	private:
+
+		Point m_goal;
+		Size m_mapSize;
+		Array<uint16> m_distances;
+		Array<int32> m_queue;
+	};
+}
+
+#endif // !BNSCUP_FLOWFIELD_H_
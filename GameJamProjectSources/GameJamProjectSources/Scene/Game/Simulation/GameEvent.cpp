@@ -0,0 +1,38 @@
+﻿#include "GameEvent.h"
+
+namespace bnscup
+{
+	GameEventQueue::GameEventQueue()
+		: m_events{}
+	{
+	}
+
+	GameEventQueue::~GameEventQueue()
+	{
+	}
+
+	void GameEventQueue::reserve(size_t count)
+	{
+		m_events.reserve(count);
+	}
+
+	void GameEventQueue::push(const GameEvent& event)
+	{
+		m_events.push_back(event);
+	}
+
+	void GameEventQueue::clear()
+	{
+		m_events.clear();
+	}
+
+	bool GameEventQueue::isEmpty() const
+	{
+		return m_events.isEmpty();
+	}
+
+	const Array<GameEvent>& GameEventQueue::getEvents() const
+	{
+		return m_events;
+	}
+}
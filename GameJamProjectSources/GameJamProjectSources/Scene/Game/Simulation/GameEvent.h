@@ -0,0 +1,61 @@
+﻿#pragma once
+#ifndef BNSCUP_GAMEEVENT_H_
+#define BNSCUP_GAMEEVENT_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	enum class GameEventType : uint8
+	{
+		MoveStarted,	// プレイヤーが隣の部屋へ動き出した
+		Bumped,			// 向かい合った敵がいてその場に留まった
+		KeyCollected,	// 鍵を拾った（index: 鍵の番号）
+		DoorUnlocked,	// 扉の鍵を開けた（index: 開けた向き）
+		UnitRescued,	// 救助した（index: 救助対象の番号）
+		PlayerCaught,	// 敵に捕まった
+		PlayerEscaped,	// 脱出した
+		Undone,
+		Redone,
+
+		Count,
+	};
+
+	/**
+	 * @brief シミュレーションで起きたこと
+	 * @details 音や表示はシミュレーションから直接呼ばず、このイベントを見て後からまとめて行う。
+	 */
+	struct GameEvent
+	{
+		GameEventType type;
+		uint32 turn;
+		Point pos;		// 起きた部屋
+		int32 index;	// 種類ごとの補足（使わない場合は -1）
+	};
+
+	/**
+	 * @brief フレームの間に起きたイベントを溜めておく列
+	 * @details 消費側が1フレームに1回まとめて読み、読み終わったら clear() する。
+	 *          clear() しても確保した領域は残すので、溜めるときに確保し直さない。
+	 */
+	class GameEventQueue
+	{
+	public:
+
+		explicit GameEventQueue();
+		virtual ~GameEventQueue();
+
+		void reserve(size_t count);
+		void push(const GameEvent& event);
+		void clear();
+
+		bool isEmpty() const;
+		const Array<GameEvent>& getEvents() const;
+
+	private:
+
+		Array<GameEvent> m_events;
+	};
+}
+
+#endif // !BNSCUP_GAMEEVENT_H_
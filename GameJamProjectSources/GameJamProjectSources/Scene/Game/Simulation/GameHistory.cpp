@@ -0,0 +1,156 @@
+﻿#include "GameHistory.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// フレーム先頭に永続部の番号を uint16 x2 で持つ
+		constexpr size_t FRAME_HEADER_SIZE = 2;
+	}
+
+	GameHistory::GameHistory(size_t frameSize, size_t persistentSize)
+		: m_frameSize{ frameSize }
+		, m_persistentSize{ persistentSize }
+		, m_frames{}
+		, m_persistents{}
+		, m_count{ 0 }
+		, m_cursor{ 0 }
+	{
+	}
+
+	GameHistory::~GameHistory()
+	{
+	}
+
+	void GameHistory::clear()
+	{
+		m_frames.clear();
+		m_persistents.clear();
+		m_count = 0;
+		m_cursor = 0;
+	}
+
+	void GameHistory::push(const uint16* frame, const uint8* persistent)
+	{
+		const size_t stride = FRAME_HEADER_SIZE + m_frameSize;
+
+		// やり直し分を捨てる。永続部は番号が単調増加なので末尾から切れる
+		if (not(isEmpty()))
+		{
+			m_count = m_cursor + 1;
+			m_frames.resize(m_count * stride);
+			m_persistents.resize((getPersistentIndex(m_cursor) + 1) * m_persistentSize);
+		}
+
+		// 永続部は直前と同じなら共有する
+		size_t persistentIndex = 0;
+		const bool isSharedPersistent = not(isEmpty())
+			and std::equal(persistent, persistent + m_persistentSize, getPersistent());
+		if (isSharedPersistent)
+		{
+			persistentIndex = getPersistentIndex(m_cursor);
+		}
+		else
+		{
+			persistentIndex = (m_persistentSize == 0) ? 0 : (m_persistents.size() / m_persistentSize);
+			m_persistents.insert(m_persistents.end(), persistent, persistent + m_persistentSize);
+		}
+
+		m_frames.push_back(static_cast<uint16>(persistentIndex & 0xFFFF));
+		m_frames.push_back(static_cast<uint16>(persistentIndex >> 16));
+		m_frames.insert(m_frames.end(), frame, frame + m_frameSize);
+		m_cursor = m_count;
+		m_count++;
+	}
+
+	bool GameHistory::canUndo() const
+	{
+		return (0 < m_cursor);
+	}
+
+	bool GameHistory::canRedo() const
+	{
+		return ((m_cursor + 1) < m_count);
+	}
+
+	bool GameHistory::undo()
+	{
+		if (not(canUndo()))
+		{
+			return false;
+		}
+		m_cursor--;
+		return true;
+	}
+
+	bool GameHistory::redo()
+	{
+		if (not(canRedo()))
+		{
+			return false;
+		}
+		m_cursor++;
+		return true;
+	}
+
+	bool GameHistory::isEmpty() const
+	{
+		return (m_count == 0);
+	}
+
+	size_t GameHistory::getCount() const
+	{
+		return m_count;
+	}
+
+	size_t GameHistory::getCursor() const
+	{
+		return m_cursor;
+	}
+
+	const uint16* GameHistory::getFrame() const
+	{
+		return getFrame(m_cursor);
+	}
+
+	const uint8* GameHistory::getPersistent() const
+	{
+		return getPersistent(m_cursor);
+	}
+
+	const uint16* GameHistory::getFrame(size_t entry) const
+	{
+		DEBUG_BREAK(m_count <= entry);
+		const size_t stride = FRAME_HEADER_SIZE + m_frameSize;
+		return m_frames.data() + (entry * stride) + FRAME_HEADER_SIZE;
+	}
+
+	const uint8* GameHistory::getPersistent(size_t entry) const
+	{
+		DEBUG_BREAK(m_count <= entry);
+		return m_persistents.data() + (getPersistentIndex(entry) * m_persistentSize);
+	}
+
+	bool GameHistory::equalsCurrent(const uint16* frame, const uint8* persistent) const
+	{
+		if (isEmpty())
+		{
+			return false;
+		}
+		return std::equal(frame, frame + m_frameSize, getFrame())
+			and std::equal(persistent, persistent + m_persistentSize, getPersistent());
+	}
+
+	size_t GameHistory::getMemoryUsage() const
+	{
+		return (m_frames.capacity() * sizeof(uint16)) + (m_persistents.capacity() * sizeof(uint8));
+	}
+
+	size_t GameHistory::getPersistentIndex(size_t entry) const
+	{
+		const size_t stride = FRAME_HEADER_SIZE + m_frameSize;
+		const uint16* pHeader = m_frames.data() + (entry * stride);
+		return static_cast<size_t>(pHeader[0]) | (static_cast<size_t>(pHeader[1]) << 16);
+	}
+}
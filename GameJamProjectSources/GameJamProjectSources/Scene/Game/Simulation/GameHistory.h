@@ -0,0 +1,60 @@
+﻿#pragma once
+#ifndef BNSCUP_GAMEHISTORY_H_
+#define BNSCUP_GAMEHISTORY_H_
+
+#include <Siv3D.hpp>
+#include "../../../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 盤面の履歴（元に戻す / やり直す）
+	 * @details 1手ごとに変わる部分（フレーム）は固定長の uint16 列として詰めて持つ。
+	 *          解錠や鍵の取得でしか変わらない部分（永続部）は変化したときだけ追加し、
+	 *          それ以外のフレームは同じ永続部を番号で共有する。
+	 */
+	class GameHistory
+	{
+	public:
+
+		explicit GameHistory(size_t frameSize, size_t persistentSize);
+		virtual ~GameHistory();
+
+		void clear();
+
+		// カーソル以降（やり直し分）を捨てて追加する
+		void push(const uint16* frame, const uint8* persistent);
+
+		bool canUndo() const;
+		bool canRedo() const;
+		bool undo();
+		bool redo();
+
+		bool isEmpty() const;
+		size_t getCount() const;
+		size_t getCursor() const;
+
+		const uint16* getFrame() const;
+		const uint8* getPersistent() const;
+		const uint16* getFrame(size_t entry) const;
+		const uint8* getPersistent(size_t entry) const;
+		bool equalsCurrent(const uint16* frame, const uint8* persistent) const;
+
+		size_t getMemoryUsage() const;
+
+	private:
+
+		size_t getPersistentIndex(size_t entry) const;
+
+	private:
+
+		size_t m_frameSize;
+		size_t m_persistentSize;
+		SceneArray<uint16> m_frames;
+		SceneArray<uint8> m_persistents;
+		size_t m_count;
+		size_t m_cursor;
+	};
+}
+
+#endif // !BNSCUP_GAMEHISTORY_H_
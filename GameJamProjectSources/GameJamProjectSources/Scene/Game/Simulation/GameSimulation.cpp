@@ -0,0 +1,866 @@
+﻿#include "GameSimulation.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		uint16 RouteToIndex(RoomData::Route route)
+		{
+			switch (route)
+			{
+			case RoomData::Route::Up:		return 0;
+			case RoomData::Route::Right:	return 1;
+			case RoomData::Route::Down:		return 2;
+			case RoomData::Route::Left:		return 3;
+			default:						return 4;
+			}
+		}
+
+		RoomData::Route RouteFromIndex(uint16 index)
+		{
+			static const RoomData::Route ROUTE_TABLE[] =
+			{
+				RoomData::Route::Up,
+				RoomData::Route::Right,
+				RoomData::Route::Down,
+				RoomData::Route::Left,
+				RoomData::Route::None,
+			};
+			return ROUTE_TABLE[Min<uint16>(index & 0x7, 4)];
+		}
+
+		// 履歴の敵1体分: 部屋番号と向き（3bit）
+		constexpr uint16 ENEMY_ROUTE_BITS = 3;
+	}
+
+	GameSimulation::GameSimulation(const StageData& stageData, EnableHistory enableHistory)
+		: m_mapData{ stageData.rooms, stageData.tilesetName, stageData.mapSize.x, stageData.mapSize.y, stageData.chipSize }
+		, m_phase{ Phase::Idle }
+		, m_turn{ 0 }
+		, m_playerPos{ stageData.startRoom }
+		, m_enemies{}
+		, m_enemyData{ stageData.enemies }
+		, m_keys{}
+		, m_rescueTargets{}
+		, m_occupancy{}
+		, m_holdKeyBits{ 0 }
+		, m_rescuedCount{ 0 }
+		, m_unlockRoomPos{ Point::Zero() }
+		, m_unlockRoute{ RoomData::Route::None }
+		, m_rescueCandidate{ 0 }
+		, m_playerField{}
+		, m_staticFields{}
+		, m_staticFieldIndexTable{}
+		, m_isPlayerFieldUsed{ false }
+		, m_isFieldDirty{ true }
+		, m_patrolCount{ 0 }
+		, m_forecast{}
+		, m_forecastSamples{}
+		, m_forecastVisited{}
+		, m_forecastEnemies{}
+		, m_pEventQueue{ nullptr }
+		, m_history{ none }
+		, m_historyFrame{}
+		, m_historyPersistent{}
+	{
+		m_staticFieldIndexTable.assign(m_mapData.getRooms().size(), -1);
+		const auto addStaticField = [this](const Point& goal)
+			{
+				int32& fieldIndex = m_staticFieldIndexTable[goal.y * m_mapData.getMapSize().x + goal.x];
+				if (fieldIndex < 0)
+				{
+					fieldIndex = static_cast<int32>(m_staticFields.size());
+					m_staticFields.emplace_back();
+				}
+			};
+
+		m_enemies.reserve(stageData.enemies.size());
+		for (const auto& enemy : stageData.enemies)
+		{
+			m_enemies.push_back(EnemyState{ enemy.pos, enemy.moveType, enemy.moveDirection, 0 });
+			switch (enemy.moveType)
+			{
+			case EnemyMoveType::Chase:
+				m_isPlayerFieldUsed = true;
+				break;
+			case EnemyMoveType::Patrol:
+				for (const auto& waypoint : enemy.waypoints)
+				{
+					addStaticField(waypoint);
+				}
+				m_patrolCount++;
+				break;
+			case EnemyMoveType::Guard:
+				// 持ち場へ戻るための距離マップ
+				addStaticField(enemy.pos);
+				m_isPlayerFieldUsed = true;
+				break;
+			default:
+				break;
+			}
+		}
+		m_keys.reserve(stageData.keys.size());
+		for (const auto& key : stageData.keys)
+		{
+			m_keys.push_back(KeyState{ key.pos, key.color, false });
+		}
+		m_rescueTargets.reserve(stageData.rescueTargets.size());
+		for (const auto& target : stageData.rescueTargets)
+		{
+			m_rescueTargets.push_back(RescueTargetState{ target.pos, false });
+		}
+
+		rebuildOccupancy();
+
+		// 開始時点で進む向きを決めておく（向かい合いの判定に使う）
+		updateEnemyMoveDirs();
+		rebuildForecast(m_enemies, m_turn);
+
+		// 開始位置での判定
+		settle();
+
+		if (enableHistory)
+		{
+			// フレーム: 手数(2) + プレイヤーの部屋(1) + 敵ごとの部屋と向き(1) + 巡回する敵ごとの巡回地点(1)
+			// 永続部: 部屋ごとのロック + 鍵の所持 + 救助済み
+			m_historyFrame.resize(3 + m_enemies.size() + m_patrolCount);
+			m_historyPersistent.resize(m_mapData.getRooms().size() + m_keys.size() + m_rescueTargets.size());
+			m_history.emplace(m_historyFrame.size(), m_historyPersistent.size());
+			recordHistory();
+		}
+	}
+
+	GameSimulation::~GameSimulation()
+	{
+	}
+
+	GameSimulation::TurnResult GameSimulation::step(Command command)
+	{
+		if (command == Command::Undo)
+		{
+			return undo();
+		}
+		if (command == Command::Redo)
+		{
+			return redo();
+		}
+
+		TurnResult result = TurnResult::Rejected;
+		switch (m_phase)
+		{
+		case Phase::Idle:			result = stepIdle(command);				break;
+		case Phase::ConfirmUnlock:	result = stepConfirmUnlock(command);	break;
+		case Phase::ConfirmRescue:	result = stepConfirmRescue(command);	break;
+		case Phase::ConfirmEscape:	result = stepConfirmEscape(command);	break;
+		case Phase::Caught:
+		case Phase::Escaped:
+		default:					break;
+		}
+		if (result != TurnResult::Rejected)
+		{
+			recordHistory();
+		}
+		return result;
+	}
+
+	void GameSimulation::setEventQueue(GameEventQueue* pEventQueue)
+	{
+		m_pEventQueue = pEventQueue;
+	}
+
+	GameSimulation::Phase GameSimulation::getPhase() const
+	{
+		return m_phase;
+	}
+
+	uint32 GameSimulation::getTurn() const
+	{
+		return m_turn;
+	}
+
+	MapData& GameSimulation::getMapData()
+	{
+		return m_mapData;
+	}
+
+	const MapData& GameSimulation::getMapData() const
+	{
+		return m_mapData;
+	}
+
+	const Point& GameSimulation::getPlayerPos() const
+	{
+		return m_playerPos;
+	}
+
+	const Array<GameSimulation::EnemyState>& GameSimulation::getEnemies() const
+	{
+		return m_enemies;
+	}
+
+	const Array<GameSimulation::KeyState>& GameSimulation::getKeys() const
+	{
+		return m_keys;
+	}
+
+	const Array<GameSimulation::RescueTargetState>& GameSimulation::getRescueTargets() const
+	{
+		return m_rescueTargets;
+	}
+
+	uint8 GameSimulation::getHoldKeyBits() const
+	{
+		return m_holdKeyBits;
+	}
+
+	size_t GameSimulation::getRescuedCount() const
+	{
+		return m_rescuedCount;
+	}
+
+	bool GameSimulation::isAllRescued() const
+	{
+		return (m_rescuedCount == m_rescueTargets.size());
+	}
+
+	Optional<size_t> GameSimulation::getRescueCandidate() const
+	{
+		if (m_phase != Phase::ConfirmRescue)
+		{
+			return none;
+		}
+		return m_rescueCandidate;
+	}
+
+	bool GameSimulation::canUndo() const
+	{
+		if (not(m_history) or m_history->isEmpty())
+		{
+			return false;
+		}
+		// 捕まったときは直前の盤面に戻せる
+		if (m_phase == Phase::Caught)
+		{
+			return true;
+		}
+		return (m_phase == Phase::Idle) and m_history->canUndo();
+	}
+
+	bool GameSimulation::canRedo() const
+	{
+		if (not(m_history))
+		{
+			return false;
+		}
+		return (m_phase == Phase::Idle) and m_history->canRedo();
+	}
+
+	const GameHistory* GameSimulation::getHistory() const
+	{
+		return m_history ? &(*m_history) : nullptr;
+	}
+
+	const EnemyForecast& GameSimulation::getEnemyForecast() const
+	{
+		return m_forecast;
+	}
+
+	GameSimulation::Command GameSimulation::CommandFromRoute(RoomData::Route route)
+	{
+		switch (route)
+		{
+		case RoomData::Route::Up:		return Command::Up;
+		case RoomData::Route::Right:	return Command::Right;
+		case RoomData::Route::Down:		return Command::Down;
+		case RoomData::Route::Left:		return Command::Left;
+		default:						return Command::None;
+		}
+	}
+
+	RoomData::Route GameSimulation::RouteFromCommand(Command command)
+	{
+		switch (command)
+		{
+		case Command::Up:		return RoomData::Route::Up;
+		case Command::Right:	return RoomData::Route::Right;
+		case Command::Down:		return RoomData::Route::Down;
+		case Command::Left:		return RoomData::Route::Left;
+		default:				return RoomData::Route::None;
+		}
+	}
+
+	GameSimulation::TurnResult GameSimulation::stepIdle(Command command)
+	{
+		if (command == Command::Escape)
+		{
+			m_phase = Phase::ConfirmEscape;
+			return TurnResult::AskEscape;
+		}
+
+		const auto route = RouteFromCommand(command);
+		if (route == RoomData::Route::None)
+		{
+			return TurnResult::Rejected;
+		}
+		return movePlayer(route);
+	}
+
+	GameSimulation::TurnResult GameSimulation::stepConfirmUnlock(Command command)
+	{
+		if (command == Command::Yes)
+		{
+			m_mapData.getRoomData(m_unlockRoomPos).unlock(m_unlockRoute);
+			pushEvent(GameEventType::DoorUnlocked, m_unlockRoomPos, FromEnum(m_unlockRoute));
+			m_unlockRoute = RoomData::Route::None;
+			// 通れる道が増えたので距離マップを作り直して向きを決め直す
+			m_isFieldDirty = true;
+			updateEnemyMoveDirs();
+			rebuildForecast(m_enemies, m_turn);
+			m_phase = Phase::Idle;
+			return TurnResult::Unlocked;
+		}
+		if (command == Command::No)
+		{
+			m_unlockRoute = RoomData::Route::None;
+			m_phase = Phase::Idle;
+			return TurnResult::Cancelled;
+		}
+		return TurnResult::Rejected;
+	}
+
+	GameSimulation::TurnResult GameSimulation::stepConfirmRescue(Command command)
+	{
+		if (command == Command::Yes)
+		{
+			auto& target = m_rescueTargets[m_rescueCandidate];
+			DEBUG_BREAK(target.isRescued);
+			target.isRescued = true;
+			m_rescuedCount++;
+			m_occupancy.remove(RoomOccupancy::Layer::RescueTarget, m_rescueCandidate);
+			pushEvent(GameEventType::UnitRescued, target.pos, static_cast<int32>(m_rescueCandidate));
+			m_phase = Phase::Idle;
+
+			// 同じ部屋に残っている救助対象、全員救助済みの確認
+			settle();
+			if (m_phase == Phase::Idle and isAllRescued())
+			{
+				m_phase = Phase::ConfirmEscape;
+			}
+			return TurnResult::Rescued;
+		}
+		if (command == Command::No)
+		{
+			m_phase = Phase::Idle;
+			return TurnResult::Cancelled;
+		}
+		return TurnResult::Rejected;
+	}
+
+	GameSimulation::TurnResult GameSimulation::stepConfirmEscape(Command command)
+	{
+		if (command == Command::Yes)
+		{
+			m_phase = Phase::Escaped;
+			pushEvent(GameEventType::PlayerEscaped, m_playerPos);
+			return TurnResult::Escaped;
+		}
+		if (command == Command::No)
+		{
+			m_phase = Phase::Idle;
+			return TurnResult::Cancelled;
+		}
+		return TurnResult::Rejected;
+	}
+
+	GameSimulation::TurnResult GameSimulation::movePlayer(RoomData::Route route)
+	{
+		const auto& nowRoom = m_mapData.getRoomData(m_playerPos);
+		if (not(nowRoom.canPassable(route)))
+		{
+			return TurnResult::Blocked;
+		}
+		if (nowRoom.isLocked(route))
+		{
+			return requestUnlock(m_playerPos, route);
+		}
+
+		const Point nextPos = m_playerPos + RoomData::GetRouteOffset(route);
+		const auto reverseRoute = RoomData::GetReverseRoute(route);
+
+		// 移動先に向かい合っている敵がいれば、その場に留まる
+		for (int32 i = m_occupancy.getFirst(RoomOccupancy::Layer::Enemy, nextPos); i != RoomOccupancy::NONE; i = m_occupancy.getNext(RoomOccupancy::Layer::Enemy, i))
+		{
+			if (m_enemies[i].moveDirection == reverseRoute)
+			{
+				pushEvent(GameEventType::Bumped, m_playerPos, FromEnum(route));
+				moveEnemies();
+				settle();
+				return TurnResult::Bumped;
+			}
+		}
+
+		const auto& targetRoom = m_mapData.getRoomData(nextPos);
+		if (not(targetRoom.canPassable(reverseRoute)))
+		{
+			return TurnResult::Blocked;
+		}
+		if (targetRoom.isLocked(reverseRoute))
+		{
+			return requestUnlock(nextPos, reverseRoute);
+		}
+
+		pushEvent(GameEventType::MoveStarted, nextPos, FromEnum(route));
+		m_playerPos = nextPos;
+		moveEnemies();
+		settle();
+		return TurnResult::Moved;
+	}
+
+	GameSimulation::TurnResult GameSimulation::requestUnlock(const Point& roomPos, RoomData::Route route)
+	{
+		// 扉と同じ色の鍵を持っているか
+		if (not(m_mapData.getRoomData(roomPos).canUnlock(route, m_holdKeyBits)))
+		{
+			return TurnResult::NoKey;
+		}
+		m_unlockRoomPos = roomPos;
+		m_unlockRoute = route;
+		m_phase = Phase::ConfirmUnlock;
+		return TurnResult::AskUnlock;
+	}
+
+	void GameSimulation::moveEnemies()
+	{
+		// 距離マップは敵ごとではなく1手につき1回だけ作る
+		updateFlowFields();
+
+		for (size_t i = 0; i < m_enemies.size(); ++i)
+		{
+			checkEnemyMoveDir(m_enemies[i], m_enemyData[i]);
+			m_enemies[i].pos += RoomData::GetRouteOffset(m_enemies[i].moveDirection);
+			m_occupancy.move(RoomOccupancy::Layer::Enemy, i, m_enemies[i].pos);
+		}
+		// 移動後の向きを先に確定させておく（向かい合いの判定に使う）
+		updateEnemyMoveDirs();
+		m_turn++;
+	}
+
+	void GameSimulation::updateEnemyMoveDirs()
+	{
+		updateFlowFields();
+		for (size_t i = 0; i < m_enemies.size(); ++i)
+		{
+			checkEnemyMoveDir(m_enemies[i], m_enemyData[i]);
+		}
+	}
+
+	void GameSimulation::checkEnemyMoveDir(EnemyState& enemy, const EnemyData& enemyData) const
+	{
+		switch (enemy.moveType)
+		{
+		case EnemyMoveType::Chase:
+			enemy.moveDirection = m_playerField.getNextRoute(m_mapData, enemy.pos);
+			return;
+		case EnemyMoveType::Patrol:
+		{
+			const auto& waypoints = enemyData.waypoints;
+			if (waypoints.isEmpty())
+			{
+				enemy.moveDirection = RoomData::Route::None;
+				return;
+			}
+			if (enemy.pos == waypoints[enemy.waypointIndex])
+			{
+				enemy.waypointIndex = (enemy.waypointIndex + 1) % waypoints.size();
+			}
+			enemy.moveDirection = getStaticField(waypoints[enemy.waypointIndex]).getNextRoute(m_mapData, enemy.pos);
+			return;
+		}
+		case EnemyMoveType::Guard:
+		{
+			const uint16 distance = m_playerField.getDistance(enemy.pos);
+			if (distance != FlowField::UNREACHABLE
+				and distance <= static_cast<uint32>(Max(enemyData.guardRange, 0)))
+			{
+				enemy.moveDirection = m_playerField.getNextRoute(m_mapData, enemy.pos);
+			}
+			else
+			{
+				// 持ち場へ戻る
+				enemy.moveDirection = getStaticField(enemyData.pos).getNextRoute(m_mapData, enemy.pos);
+			}
+			return;
+		}
+		case EnemyMoveType::UpDown:
+		case EnemyMoveType::LeftRight:
+		default:
+			break;
+		}
+
+		const auto& roomData = m_mapData.getRoomData(enemy.pos);
+		const auto moveDirection = enemy.moveDirection;
+		if (roomData.canPassable(moveDirection)
+			and not(roomData.isLocked(moveDirection)))
+		{
+			return;
+		}
+
+		if (enemy.moveType == EnemyMoveType::UpDown)
+		{
+			enemy.moveDirection = (moveDirection == RoomData::Route::Up) ? RoomData::Route::Down : RoomData::Route::Up;
+		}
+		else if (enemy.moveType == EnemyMoveType::LeftRight)
+		{
+			enemy.moveDirection = (moveDirection == RoomData::Route::Left) ? RoomData::Route::Right : RoomData::Route::Left;
+		}
+		DEBUG_BREAK(not(roomData.canPassable(enemy.moveDirection)));
+		DEBUG_BREAK(roomData.isLocked(enemy.moveDirection));
+	}
+
+	void GameSimulation::updateFlowFields()
+	{
+		if (m_isFieldDirty)
+		{
+			for (size_t i = 0; i < m_staticFieldIndexTable.size(); ++i)
+			{
+				const int32 fieldIndex = m_staticFieldIndexTable[i];
+				if (0 <= fieldIndex)
+				{
+					const int32 mapWidth = m_mapData.getMapSize().x;
+					const Point goal{ static_cast<int32>(i) % mapWidth, static_cast<int32>(i) / mapWidth };
+					m_staticFields[fieldIndex].build(m_mapData, goal);
+				}
+			}
+		}
+
+		if (m_isPlayerFieldUsed
+			and (m_isFieldDirty or m_playerField.getGoal() != m_playerPos or not(m_playerField.isBuilt())))
+		{
+			m_playerField.build(m_mapData, m_playerPos);
+		}
+		m_isFieldDirty = false;
+	}
+
+	const FlowField& GameSimulation::getStaticField(const Point& goal) const
+	{
+		const int32 fieldIndex = m_staticFieldIndexTable[goal.y * m_mapData.getMapSize().x + goal.x];
+		DEBUG_BREAK(fieldIndex < 0); // 生成時に登録していない地点
+		return m_staticFields[Max(fieldIndex, 0)];
+	}
+
+	void GameSimulation::rebuildForecast(const Array<EnemyState>& enemies, uint32 baseTurn)
+	{
+		updateFlowFields();
+
+		const int32 mapWidth = m_mapData.getMapSize().x;
+		const size_t roomCount = m_mapData.getRooms().size();
+		m_forecast.reset(m_mapData.getMapSize(), baseTurn, enemies.size());
+		for (size_t i = 0; i < enemies.size(); ++i)
+		{
+			const auto& enemyData = m_enemyData[i];
+			if (enemyData.moveType == EnemyMoveType::Chase
+				or enemyData.moveType == EnemyMoveType::Guard)
+			{
+				// プレイヤー次第なので先読みできない
+				continue;
+			}
+
+			// 状態（部屋、向き、巡回地点）が初めて現れた手を覚えておき、再び現れたらそこからが周期
+			const size_t waypointCount = Max<size_t>(enemyData.waypoints.size(), 1);
+			m_forecastVisited.assign(roomCount * 5 * waypointCount, -1);
+			m_forecastSamples.clear();
+
+			EnemyState enemy = enemies[i];
+			while (true)
+			{
+				const size_t roomIndex = static_cast<size_t>(enemy.pos.y * mapWidth + enemy.pos.x);
+				const size_t stateIndex = (roomIndex * 5 + RouteToIndex(enemy.moveDirection)) * waypointCount + enemy.waypointIndex;
+				if (0 <= m_forecastVisited[stateIndex])
+				{
+					m_forecast.setTrajectory(i, m_forecastSamples, static_cast<size_t>(m_forecastVisited[stateIndex]));
+					break;
+				}
+				m_forecastVisited[stateIndex] = static_cast<int32>(m_forecastSamples.size());
+				m_forecastSamples.push_back(EnemyForecast::Sample{ enemy.pos, enemy.moveDirection });
+
+				// moveEnemies と同じ手順で1手進める
+				checkEnemyMoveDir(enemy, enemyData);
+				enemy.pos += RoomData::GetRouteOffset(enemy.moveDirection);
+				checkEnemyMoveDir(enemy, enemyData);
+			}
+		}
+		m_forecast.finalize();
+	}
+
+	void GameSimulation::settle()
+	{
+		// 鍵の取得（拾った鍵は索引から外す）
+		int32 keyIndex = m_occupancy.getFirst(RoomOccupancy::Layer::Key, m_playerPos);
+		while (keyIndex != RoomOccupancy::NONE)
+		{
+			const int32 nextKeyIndex = m_occupancy.getNext(RoomOccupancy::Layer::Key, keyIndex);
+			DEBUG_BREAK(m_keys[keyIndex].isHeld);
+			m_keys[keyIndex].isHeld = true;
+			m_holdKeyBits |= FromEnum(m_keys[keyIndex].color);
+			m_occupancy.remove(RoomOccupancy::Layer::Key, keyIndex);
+			pushEvent(GameEventType::KeyCollected, m_playerPos, keyIndex);
+			keyIndex = nextKeyIndex;
+		}
+
+		// 敵との接触
+		if (m_occupancy.isOccupied(RoomOccupancy::Layer::Enemy, m_playerPos))
+		{
+			m_phase = Phase::Caught;
+			pushEvent(GameEventType::PlayerCaught, m_playerPos);
+			return;
+		}
+
+		// 救助対象の発見（救助済みは索引に残っていない）
+		const int32 targetIndex = m_occupancy.getFirst(RoomOccupancy::Layer::RescueTarget, m_playerPos);
+		if (targetIndex != RoomOccupancy::NONE)
+		{
+			m_rescueCandidate = static_cast<size_t>(targetIndex);
+			m_phase = Phase::ConfirmRescue;
+			return;
+		}
+	}
+
+	void GameSimulation::rebuildOccupancy()
+	{
+		m_occupancy.reset(m_mapData.getMapSize());
+		m_occupancy.resize(RoomOccupancy::Layer::Enemy, m_enemies.size());
+		m_occupancy.resize(RoomOccupancy::Layer::Key, m_keys.size());
+		m_occupancy.resize(RoomOccupancy::Layer::RescueTarget, m_rescueTargets.size());
+
+		// 後ろから積んで、同じ部屋では番号の小さいものが先に返るようにする
+		for (size_t i = m_enemies.size(); 0 < i; --i)
+		{
+			m_occupancy.insert(RoomOccupancy::Layer::Enemy, i - 1, m_enemies[i - 1].pos);
+		}
+		for (size_t i = m_keys.size(); 0 < i; --i)
+		{
+			if (not(m_keys[i - 1].isHeld))
+			{
+				m_occupancy.insert(RoomOccupancy::Layer::Key, i - 1, m_keys[i - 1].pos);
+			}
+		}
+		for (size_t i = m_rescueTargets.size(); 0 < i; --i)
+		{
+			if (not(m_rescueTargets[i - 1].isRescued))
+			{
+				m_occupancy.insert(RoomOccupancy::Layer::RescueTarget, i - 1, m_rescueTargets[i - 1].pos);
+			}
+		}
+	}
+
+	void GameSimulation::pushEvent(GameEventType type, const Point& pos, int32 index)
+	{
+		if (m_pEventQueue == nullptr)
+		{
+			return;
+		}
+		m_pEventQueue->push(GameEvent{ type, m_turn, pos, index });
+	}
+
+	GameSimulation::TurnResult GameSimulation::undo()
+	{
+		if (not(canUndo()))
+		{
+			return TurnResult::Rejected;
+		}
+		// 捕まった盤面は記録していないので、カーソル位置がそのまま直前の盤面
+		if (m_phase != Phase::Caught)
+		{
+			m_history->undo();
+		}
+		restoreHistory();
+		pushEvent(GameEventType::Undone, m_playerPos);
+		return TurnResult::Undone;
+	}
+
+	GameSimulation::TurnResult GameSimulation::redo()
+	{
+		if (not(canRedo()))
+		{
+			return TurnResult::Rejected;
+		}
+		m_history->redo();
+		restoreHistory();
+		pushEvent(GameEventType::Redone, m_playerPos);
+		return TurnResult::Redone;
+	}
+
+	void GameSimulation::recordHistory()
+	{
+		// 操作できる盤面だけを記録する
+		if (not(m_history) or m_phase != Phase::Idle)
+		{
+			return;
+		}
+		writeHistoryFrame();
+		if (m_history->equalsCurrent(m_historyFrame.data(), m_historyPersistent.data()))
+		{
+			return;
+		}
+		m_history->push(m_historyFrame.data(), m_historyPersistent.data());
+	}
+
+	void GameSimulation::restoreHistory()
+	{
+		const uint16* frame = m_history->getFrame();
+		const uint8* persistent = m_history->getPersistent();
+		const int32 mapWidth = m_mapData.getMapSize().x;
+
+		m_turn = static_cast<uint32>(frame[0]) | (static_cast<uint32>(frame[1]) << 16);
+		m_playerPos = Point{ frame[2] % mapWidth, frame[2] / mapWidth };
+		readHistoryEnemies(frame, m_enemies);
+		for (size_t i = 0; i < m_enemies.size(); ++i)
+		{
+			// 部屋が変わっていなければ何もしない
+			m_occupancy.move(RoomOccupancy::Layer::Enemy, i, m_enemies[i].pos);
+		}
+
+		// 実際に変わった部屋だけ書き戻す
+		bool isLockChanged = false;
+		const size_t roomCount = m_mapData.getRooms().size();
+		for (size_t i = 0; i < roomCount; ++i)
+		{
+			const Point roomPos{ static_cast<int32>(i) % mapWidth, static_cast<int32>(i) / mapWidth };
+			auto& room = m_mapData.getRoomData(roomPos);
+			if (room.getLockBits() != persistent[i])
+			{
+				room.setLockBits(persistent[i]);
+				isLockChanged = true;
+			}
+		}
+		persistent += roomCount;
+
+		// 所持や救助が変わったものだけ索引に出し入れする
+		m_holdKeyBits = 0;
+		for (size_t i = 0; i < m_keys.size(); ++i)
+		{
+			auto& key = m_keys[i];
+			const bool isHeld = (*persistent++ != 0);
+			if (isHeld != key.isHeld)
+			{
+				key.isHeld = isHeld;
+				if (isHeld)
+				{
+					m_occupancy.remove(RoomOccupancy::Layer::Key, i);
+				}
+				else
+				{
+					m_occupancy.insert(RoomOccupancy::Layer::Key, i, key.pos);
+				}
+			}
+			m_holdKeyBits |= key.isHeld ? FromEnum(key.color) : 0;
+		}
+		m_rescuedCount = 0;
+		for (size_t i = 0; i < m_rescueTargets.size(); ++i)
+		{
+			auto& target = m_rescueTargets[i];
+			const bool isRescued = (*persistent++ != 0);
+			if (isRescued != target.isRescued)
+			{
+				target.isRescued = isRescued;
+				if (isRescued)
+				{
+					m_occupancy.remove(RoomOccupancy::Layer::RescueTarget, i);
+				}
+				else
+				{
+					m_occupancy.insert(RoomOccupancy::Layer::RescueTarget, i, target.pos);
+				}
+			}
+			m_rescuedCount += target.isRescued ? 1 : 0;
+		}
+
+		m_unlockRoute = RoomData::Route::None;
+		m_rescueCandidate = 0;
+		m_phase = Phase::Idle;
+
+		// 地形が同じなら距離マップも先読みもそのまま使える（先読みは基準の手以降ならどの手からでも引ける）
+		if (not(isLockChanged) and m_forecast.getBaseTurn() <= m_turn)
+		{
+			return;
+		}
+
+		// ロックが同じ区間の先頭の盤面から先読みし直す。以降の undo / redo はこの区間にいる限り作り直さない
+		m_isFieldDirty = (m_isFieldDirty or isLockChanged);
+		const uint16* baseFrame = m_history->getFrame(findLockRangeBegin());
+		m_forecastEnemies.assign(m_enemies.begin(), m_enemies.end());
+		readHistoryEnemies(baseFrame, m_forecastEnemies);
+		rebuildForecast(m_forecastEnemies, static_cast<uint32>(baseFrame[0]) | (static_cast<uint32>(baseFrame[1]) << 16));
+	}
+
+	void GameSimulation::readHistoryEnemies(const uint16* frame, Array<EnemyState>& enemies) const
+	{
+		const int32 mapWidth = m_mapData.getMapSize().x;
+		const uint16* patrolFrame = frame + 3 + enemies.size();
+		for (size_t i = 0; i < enemies.size(); ++i)
+		{
+			const uint16 packed = frame[3 + i];
+			const int32 roomIndex = (packed >> ENEMY_ROUTE_BITS);
+			enemies[i].pos = Point{ roomIndex % mapWidth, roomIndex / mapWidth };
+			enemies[i].moveDirection = RouteFromIndex(packed);
+			if (enemies[i].moveType == EnemyMoveType::Patrol)
+			{
+				enemies[i].waypointIndex = *patrolFrame++;
+			}
+		}
+	}
+
+	size_t GameSimulation::findLockRangeBegin() const
+	{
+		// 永続部を共有している間はロックも同じなので、番号が変わったところだけ中身を比べる
+		const size_t roomCount = m_mapData.getRooms().size();
+		size_t entry = m_history->getCursor();
+		const uint8* pLocks = m_history->getPersistent(entry);
+		while (0 < entry)
+		{
+			const uint8* pPrevLocks = m_history->getPersistent(entry - 1);
+			if (pPrevLocks != pLocks and not(std::equal(pLocks, pLocks + roomCount, pPrevLocks)))
+			{
+				break;
+			}
+			pLocks = pPrevLocks;
+			entry--;
+		}
+		return entry;
+	}
+
+	void GameSimulation::writeHistoryFrame()
+	{
+		const int32 mapWidth = m_mapData.getMapSize().x;
+
+		m_historyFrame[0] = static_cast<uint16>(m_turn & 0xFFFF);
+		m_historyFrame[1] = static_cast<uint16>(m_turn >> 16);
+		m_historyFrame[2] = static_cast<uint16>(m_playerPos.y * mapWidth + m_playerPos.x);
+		uint16* patrolFrame = m_historyFrame.data() + 3 + m_enemies.size();
+		for (size_t i = 0; i < m_enemies.size(); ++i)
+		{
+			const auto& enemy = m_enemies[i];
+			const int32 roomIndex = enemy.pos.y * mapWidth + enemy.pos.x;
+			m_historyFrame[3 + i] = static_cast<uint16>((roomIndex << ENEMY_ROUTE_BITS) | RouteToIndex(enemy.moveDirection));
+			if (enemy.moveType == EnemyMoveType::Patrol)
+			{
+				*patrolFrame++ = static_cast<uint16>(enemy.waypointIndex);
+			}
+		}
+
+		uint8* persistent = m_historyPersistent.data();
+		for (const auto& room : m_mapData.getRooms())
+		{
+			*persistent++ = room.getLockBits();
+		}
+		for (const auto& key : m_keys)
+		{
+			*persistent++ = key.isHeld ? 1 : 0;
+		}
+		for (const auto& target : m_rescueTargets)
+		{
+			*persistent++ = target.isRescued ? 1 : 0;
+		}
+	}
+}
@@ -0,0 +1,197 @@
+﻿#pragma once
+#ifndef BNSCUP_GAMESIMULATION_H_
+#define BNSCUP_GAMESIMULATION_H_
+
+#include <Siv3D.hpp>
+#include "StageData.h"
+#include "GameHistory.h"
+#include "FlowField.h"
+#include "EnemyForecast.h"
+#include "RoomOccupancy.h"
+#include "GameEvent.h"
+#include "../Map/MapData.h"
+#include "../Map/RoomData.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief ゲームルールのみを扱うシミュレーション
+	 * @details 描画、音、入力デバイスには依存しない。
+	 *          入力（コマンド）1つにつき1手だけ状態を進める。
+	 *          起きたことはイベント列に積むだけで、音や表示は受け取った側がまとめて行う。
+	 */
+	class GameSimulation
+	{
+	public:
+
+		enum class Command : uint8
+		{
+			None = 0,
+			Up,
+			Right,
+			Down,
+			Left,
+			Yes,
+			No,
+			Escape,
+			Undo,
+			Redo,
+		};
+
+		enum class Phase : uint8
+		{
+			Idle,
+			ConfirmUnlock,
+			ConfirmRescue,
+			ConfirmEscape,
+			Caught,
+			Escaped,
+		};
+
+		enum class TurnResult : uint8
+		{
+			Rejected,	// 今の状態では受け付けない入力
+			Blocked,	// 壁
+			NoKey,		// 鍵がかかっているが同じ色の鍵を持っていない
+			Moved,		// プレイヤーと敵が移動した
+			Bumped,		// 向かい合った敵がいたのでプレイヤーは移動せず敵だけ移動した
+			AskUnlock,
+			AskEscape,
+			Unlocked,
+			Rescued,
+			Escaped,
+			Cancelled,
+			Undone,
+			Redone,
+		};
+
+		struct EnemyState
+		{
+			Point pos;
+			EnemyMoveType moveType;
+			RoomData::Route moveDirection;	// 次に進む向き（立ち止まる場合は None）
+			size_t waypointIndex;			// Patrol の次の巡回地点
+		};
+
+		struct KeyState
+		{
+			Point pos;
+			RoomData::KeyColor color;
+			bool isHeld;
+		};
+
+		struct RescueTargetState
+		{
+			Point pos;
+			bool isRescued;
+		};
+
+	public:
+
+		using EnableHistory = YesNo<struct EnableHistory_tag>;
+
+		explicit GameSimulation(const StageData& stageData, EnableHistory enableHistory = EnableHistory::No);
+		virtual ~GameSimulation();
+
+		TurnResult step(Command command);
+
+		// イベントの積み先（nullptr なら積まない）
+		void setEventQueue(GameEventQueue* pEventQueue);
+
+		Phase getPhase() const;
+		uint32 getTurn() const;
+
+		MapData& getMapData();
+		const MapData& getMapData() const;
+
+		const Point& getPlayerPos() const;
+		const Array<EnemyState>& getEnemies() const;
+		const Array<KeyState>& getKeys() const;
+		const Array<RescueTargetState>& getRescueTargets() const;
+
+		// 持っている鍵の色のビットの和
+		uint8 getHoldKeyBits() const;
+		size_t getRescuedCount() const;
+		bool isAllRescued() const;
+
+		// ConfirmRescue 中の救助対象
+		Optional<size_t> getRescueCandidate() const;
+
+		bool canUndo() const;
+		bool canRedo() const;
+		const GameHistory* getHistory() const;
+
+		// 往復、巡回する敵の先読み（追いかける敵は含まない）
+		const EnemyForecast& getEnemyForecast() const;
+
+		static Command CommandFromRoute(RoomData::Route route);
+		static RoomData::Route RouteFromCommand(Command command);
+
+	private:
+
+		TurnResult stepIdle(Command command);
+		TurnResult stepConfirmUnlock(Command command);
+		TurnResult stepConfirmRescue(Command command);
+		TurnResult stepConfirmEscape(Command command);
+
+		TurnResult movePlayer(RoomData::Route route);
+		TurnResult requestUnlock(const Point& roomPos, RoomData::Route route);
+		void moveEnemies();
+		void updateEnemyMoveDirs();
+		void checkEnemyMoveDir(EnemyState& enemy, const EnemyData& enemyData) const;
+		void updateFlowFields();
+		const FlowField& getStaticField(const Point& goal) const;
+		void rebuildForecast(const Array<EnemyState>& enemies, uint32 baseTurn);
+		void settle();
+		void rebuildOccupancy();
+		void pushEvent(GameEventType type, const Point& pos, int32 index = -1);
+
+		TurnResult undo();
+		TurnResult redo();
+		void recordHistory();
+		void restoreHistory();
+		void readHistoryEnemies(const uint16* frame, Array<EnemyState>& enemies) const;
+		size_t findLockRangeBegin() const;
+		void writeHistoryFrame();
+
+	private:
+
+		MapData m_mapData;
+		Phase m_phase;
+		uint32 m_turn;
+
+		Point m_playerPos;
+		Array<EnemyState> m_enemies;
+		Array<EnemyData> m_enemyData;
+		Array<KeyState> m_keys;
+		Array<RescueTargetState> m_rescueTargets;
+		RoomOccupancy m_occupancy;
+		uint8 m_holdKeyBits;
+		size_t m_rescuedCount;
+
+		Point m_unlockRoomPos;
+		RoomData::Route m_unlockRoute;
+		size_t m_rescueCandidate;
+
+		// 敵の移動先を決める距離マップ（敵の数によらず共有する）
+		FlowField m_playerField;
+		Array<FlowField> m_staticFields;
+		Array<int32> m_staticFieldIndexTable;	// 部屋番号 -> m_staticFields の番号
+		bool m_isPlayerFieldUsed;
+		bool m_isFieldDirty;
+		size_t m_patrolCount;
+
+		EnemyForecast m_forecast;
+		Array<EnemyForecast::Sample> m_forecastSamples;
+		Array<int32> m_forecastVisited;
+		Array<EnemyState> m_forecastEnemies;
+
+		GameEventQueue* m_pEventQueue;
+
+		Optional<GameHistory> m_history;
+		SceneArray<uint16> m_historyFrame;
+		SceneArray<uint8> m_historyPersistent;
+	};
+}
+
+#endif // !BNSCUP_GAMESIMULATION_H_
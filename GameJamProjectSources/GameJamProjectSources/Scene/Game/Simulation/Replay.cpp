@@ -0,0 +1,221 @@
+﻿#include "Replay.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		constexpr uint8 REPLAY_MAGIC[] = { 'B', 'N', 'S', 'R' };
+		constexpr uint32 REPLAY_VERSION = 2;
+
+		// コマンドは下位ビット、残りは連続数-1
+		// version 1 は Undo/Redo が無く3ビットだった
+		constexpr uint32 COMMAND_BITS = 4;
+		constexpr uint32 COMMAND_BITS_V1 = 3;
+
+		// 壊れたファイルで巨大な配列を確保しないための上限
+		constexpr uint64 MAX_COMMAND_COUNT = (1ull << 20);
+
+		uint32 GetCommandBits(uint64 version)
+		{
+			return (version == 1) ? COMMAND_BITS_V1 : COMMAND_BITS;
+		}
+
+		GameSimulation::Command GetLastCommand(uint64 version)
+		{
+			return (version == 1) ? GameSimulation::Command::Escape : GameSimulation::Command::Redo;
+		}
+
+		void WriteVarint(Array<uint8>& out, uint64 value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back(static_cast<uint8>(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<uint8>(value));
+		}
+
+		bool ReadVarint(const Array<uint8>& data, size_t& offset, uint64& value)
+		{
+			value = 0;
+			for (uint32 shift = 0; shift < 64; shift += 7)
+			{
+				if (data.size() <= offset)
+				{
+					return false;
+				}
+				const uint8 byte = data[offset++];
+				value |= (static_cast<uint64>(byte & 0x7F) << shift);
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	Replay::Replay()
+		: m_stageNo{ -1 }
+		, m_commands{}
+	{
+	}
+
+	Replay::~Replay()
+	{
+	}
+
+	void Replay::reset(int32 stageNo)
+	{
+		m_stageNo = stageNo;
+		m_commands.clear();
+	}
+
+	void Replay::record(GameSimulation::Command command)
+	{
+		m_commands.push_back(command);
+	}
+
+	int32 Replay::getStageNo() const
+	{
+		return m_stageNo;
+	}
+
+	size_t Replay::getCommandCount() const
+	{
+		return m_commands.size();
+	}
+
+	GameSimulation::Command Replay::getCommand(size_t index) const
+	{
+		if (m_commands.size() <= index)
+		{
+			DEBUG_BREAK(true);
+			return GameSimulation::Command::None;
+		}
+		return m_commands[index];
+	}
+
+	bool Replay::isEmpty() const
+	{
+		return m_commands.empty();
+	}
+
+	size_t Replay::applyTo(GameSimulation& simulation, size_t count) const
+	{
+		const size_t endIndex = Min(count, m_commands.size());
+		for (size_t i = 0; i < endIndex; ++i)
+		{
+			simulation.step(m_commands[i]);
+		}
+		return endIndex;
+	}
+
+	Array<uint8> Replay::encode() const
+	{
+		Array<uint8> data;
+		data.reserve(16 + m_commands.size());
+		data.insert(data.end(), std::begin(REPLAY_MAGIC), std::end(REPLAY_MAGIC));
+		WriteVarint(data, REPLAY_VERSION);
+		WriteVarint(data, static_cast<uint64>(Max(m_stageNo, 0)));
+		WriteVarint(data, m_commands.size());
+
+		size_t i = 0;
+		while (i < m_commands.size())
+		{
+			const auto command = m_commands[i];
+			size_t runLength = 1;
+			while ((i + runLength) < m_commands.size() and m_commands[i + runLength] == command)
+			{
+				runLength++;
+			}
+			WriteVarint(data, (static_cast<uint64>(runLength - 1) << COMMAND_BITS) | FromEnum(command));
+			i += runLength;
+		}
+		return data;
+	}
+
+	bool Replay::decode(const Array<uint8>& data)
+	{
+		if (data.size() < std::size(REPLAY_MAGIC)
+			or not(std::equal(std::begin(REPLAY_MAGIC), std::end(REPLAY_MAGIC), data.begin())))
+		{
+			return false;
+		}
+
+		size_t offset = std::size(REPLAY_MAGIC);
+		uint64 version = 0;
+		uint64 stageNo = 0;
+		uint64 commandCount = 0;
+		if (not(ReadVarint(data, offset, version))
+			or version == 0
+			or REPLAY_VERSION < version
+			or not(ReadVarint(data, offset, stageNo))
+			or not(ReadVarint(data, offset, commandCount)))
+		{
+			return false;
+		}
+		if (static_cast<uint64>(std::numeric_limits<int32>::max()) < stageNo
+			or MAX_COMMAND_COUNT < commandCount)
+		{
+			return false;
+		}
+
+		const uint32 commandBits = GetCommandBits(version);
+		const uint64 commandMask = (1ull << commandBits) - 1;
+		const uint64 lastCommand = FromEnum(GetLastCommand(version));
+		Array<GameSimulation::Command> commands;
+		commands.reserve(static_cast<size_t>(Min<uint64>(commandCount, data.size() * 8)));
+		while (commands.size() < commandCount)
+		{
+			uint64 value = 0;
+			if (not(ReadVarint(data, offset, value)))
+			{
+				return false;
+			}
+			if (lastCommand < (value & commandMask))
+			{
+				return false;
+			}
+			const auto command = ToEnum<GameSimulation::Command>(static_cast<uint8>(value & commandMask));
+			const uint64 runLength = (value >> commandBits) + 1;
+			if ((commandCount - commands.size()) < runLength)
+			{
+				return false;
+			}
+			commands.insert(commands.end(), static_cast<size_t>(runLength), command);
+		}
+
+		m_stageNo = static_cast<int32>(stageNo);
+		m_commands = std::move(commands);
+		return true;
+	}
+
+	bool Replay::save(FilePathView path) const
+	{
+		const auto data = encode();
+		BinaryWriter writer{ path };
+		if (not(writer))
+		{
+			return false;
+		}
+		writer.write(data.data(), data.size());
+		return true;
+	}
+
+	bool Replay::load(FilePathView path)
+	{
+		BinaryReader reader{ path };
+		if (not(reader))
+		{
+			return false;
+		}
+		Array<uint8> data(static_cast<size_t>(reader.size()));
+		if (reader.read(data.data(), data.size()) != static_cast<int64>(data.size()))
+		{
+			return false;
+		}
+		return decode(data);
+	}
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+#ifndef BNSCUP_REPLAY_H_
+#define BNSCUP_REPLAY_H_
+
+#include <Siv3D.hpp>
+#include "GameSimulation.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 1回のステージ挑戦の入力記録
+	 * @details ステージ番号と GameSimulation へ渡したコマンド列だけを持つ。
+	 *          保存時は同じコマンドの連続をまとめて varint で符号化する。
+	 */
+	class Replay
+	{
+	public:
+
+		explicit Replay();
+		virtual ~Replay();
+
+		void reset(int32 stageNo);
+		void record(GameSimulation::Command command);
+
+		int32 getStageNo() const;
+		size_t getCommandCount() const;
+		GameSimulation::Command getCommand(size_t index) const;
+		bool isEmpty() const;
+
+		// 演出を挟まずに先頭から count 個のコマンドを適用する
+		// Undo/Redo を含む場合は履歴を有効にした GameSimulation を渡すこと
+		size_t applyTo(GameSimulation& simulation, size_t count) const;
+
+		Array<uint8> encode() const;
+		bool decode(const Array<uint8>& data);
+
+		bool save(FilePathView path) const;
+		bool load(FilePathView path);
+
+	private:
+
+		int32 m_stageNo;
+		Array<GameSimulation::Command> m_commands;
+	};
+
+	// 再生の指定
+	struct ReplayPlayback
+	{
+		Replay replay;
+		double speed;
+		bool isSkipAnim;
+	};
+}
+
+#endif // !BNSCUP_REPLAY_H_
@@ -0,0 +1,125 @@
+﻿#include "RoomOccupancy.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	RoomOccupancy::RoomOccupancy()
+		: m_mapSize{ Size::Zero() }
+		, m_layers{}
+	{
+	}
+
+	RoomOccupancy::~RoomOccupancy()
+	{
+	}
+
+	void RoomOccupancy::reset(const Size& mapSize)
+	{
+		m_mapSize = mapSize;
+		const size_t roomCount = static_cast<size_t>(mapSize.x * mapSize.y);
+		for (auto& layer : m_layers)
+		{
+			layer.heads.assign(roomCount, NONE);
+			layer.next.assign(layer.next.size(), NONE);
+			layer.prev.assign(layer.prev.size(), NONE);
+			layer.rooms.assign(layer.rooms.size(), NONE);
+		}
+	}
+
+	void RoomOccupancy::resize(Layer layer, size_t entityCount)
+	{
+		auto& data = m_layers[FromEnum(layer)];
+		data.next.assign(entityCount, NONE);
+		data.prev.assign(entityCount, NONE);
+		data.rooms.assign(entityCount, NONE);
+		data.heads.assign(data.heads.size(), NONE);
+	}
+
+	void RoomOccupancy::insert(Layer layer, size_t entityIndex, const Point& roomPos)
+	{
+		auto& data = m_layers[FromEnum(layer)];
+		DEBUG_BREAK(data.rooms[entityIndex] != NONE); // 二重登録
+		const int32 roomIndex = toRoomIndex(roomPos);
+		const int32 index = static_cast<int32>(entityIndex);
+		const int32 head = data.heads[roomIndex];
+		data.next[index] = head;
+		data.prev[index] = NONE;
+		if (head != NONE)
+		{
+			data.prev[head] = index;
+		}
+		data.heads[roomIndex] = index;
+		data.rooms[index] = roomIndex;
+	}
+
+	void RoomOccupancy::remove(Layer layer, size_t entityIndex)
+	{
+		auto& data = m_layers[FromEnum(layer)];
+		const int32 index = static_cast<int32>(entityIndex);
+		const int32 roomIndex = data.rooms[index];
+		if (roomIndex == NONE)
+		{
+			return;
+		}
+		const int32 next = data.next[index];
+		const int32 prev = data.prev[index];
+		if (prev != NONE)
+		{
+			data.next[prev] = next;
+		}
+		else
+		{
+			data.heads[roomIndex] = next;
+		}
+		if (next != NONE)
+		{
+			data.prev[next] = prev;
+		}
+		data.next[index] = NONE;
+		data.prev[index] = NONE;
+		data.rooms[index] = NONE;
+	}
+
+	void RoomOccupancy::move(Layer layer, size_t entityIndex, const Point& roomPos)
+	{
+		const auto& data = m_layers[FromEnum(layer)];
+		if (data.rooms[entityIndex] == toRoomIndex(roomPos))
+		{
+			return;
+		}
+		remove(layer, entityIndex);
+		insert(layer, entityIndex, roomPos);
+	}
+
+	bool RoomOccupancy::contains(Layer layer, size_t entityIndex) const
+	{
+		return (m_layers[FromEnum(layer)].rooms[entityIndex] != NONE);
+	}
+
+	bool RoomOccupancy::isOccupied(Layer layer, const Point& roomPos) const
+	{
+		return (getFirst(layer, roomPos) != NONE);
+	}
+
+	int32 RoomOccupancy::getFirst(Layer layer, const Point& roomPos) const
+	{
+		if (roomPos.x < 0 or m_mapSize.x <= roomPos.x
+			or roomPos.y < 0 or m_mapSize.y <= roomPos.y)
+		{
+			return NONE;
+		}
+		return m_layers[FromEnum(layer)].heads[toRoomIndex(roomPos)];
+	}
+
+	int32 RoomOccupancy::getNext(Layer layer, size_t entityIndex) const
+	{
+		return m_layers[FromEnum(layer)].next[entityIndex];
+	}
+
+	int32 RoomOccupancy::toRoomIndex(const Point& roomPos) const
+	{
+		const int32 roomIndex = roomPos.y * m_mapSize.x + roomPos.x;
+		DEBUG_BREAK((roomIndex < 0 or m_mapSize.x * m_mapSize.y <= roomIndex));
+		return roomIndex;
+	}
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+#ifndef BNSCUP_ROOMOCCUPANCY_H_
+#define BNSCUP_ROOMOCCUPANCY_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	/**
+	 * @brief 部屋ごとにそこにいるものを引ける索引
+	 * @details 種類（層）ごと、部屋ごとに双方向リストの先頭を持ち、部屋を移ったときだけ付け替える。
+	 *          ある部屋にいる敵や鍵を調べるのに全員を見て回る必要がなくなる。
+	 */
+	class RoomOccupancy
+	{
+	public:
+
+		enum class Layer : uint8
+		{
+			Enemy,
+			Key,
+			RescueTarget,
+			Num,
+		};
+
+		static constexpr int32 NONE = -1;
+
+	public:
+
+		RoomOccupancy();
+		virtual ~RoomOccupancy();
+
+		void reset(const Size& mapSize);
+		void resize(Layer layer, size_t entityCount);
+
+		// 先頭に追加する（同じ部屋なら後から追加したものが先に返る）
+		void insert(Layer layer, size_t entityIndex, const Point& roomPos);
+		void remove(Layer layer, size_t entityIndex);
+		void move(Layer layer, size_t entityIndex, const Point& roomPos);
+
+		bool contains(Layer layer, size_t entityIndex) const;
+		bool isOccupied(Layer layer, const Point& roomPos) const;
+
+		// for (int32 i = getFirst(...); i != NONE; i = getNext(...)) でたどる
+		int32 getFirst(Layer layer, const Point& roomPos) const;
+		int32 getNext(Layer layer, size_t entityIndex) const;
+
+	private:
+
+		struct LayerData
+		{
+			Array<int32> heads;	// 部屋ごとの先頭
+			Array<int32> next;
+			Array<int32> prev;
+			Array<int32> rooms;	// どの部屋にいるか（いなければ NONE）
+		};
+
+		int32 toRoomIndex(const Point& roomPos) const;
+
+	private:
+
+		Size m_mapSize;
+		LayerData m_layers[FromEnum(Layer::Num)];
+	};
+}
+
+#endif // !BNSCUP_ROOMOCCUPANCY_H_
@@ -0,0 +1,131 @@
+﻿#include "StageData.h"
+#include "../../../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		constexpr int32 STAGE_COUNT = 4;
+	}
+
+	int32 GetStageCount()
+	{
+		return STAGE_COUNT;
+	}
+
+	bool CreateStageData(int32 stageNo, StageData& stageData)
+	{
+		stageData = StageData{};
+		stageData.tilesetName = U"dungeon_tileset";
+		stageData.chipSize = 16;
+
+		// あとでステージ生成クラスとかにまとめたい
+		if (stageNo == 0)
+		{
+			stageData.mapSize = Size{ 2, 3 };
+			stageData.rooms =
+			{
+				RoomData{ FromEnum(RoomData::Route::Down)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::None), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::Up)   }, RoomData{ FromEnum(RoomData::Route::Left), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::Up)         , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::None), FromEnum(RoomData::Route::None) },
+			};
+			stageData.startRoom = Point{ 0, 2 };
+			stageData.rescueTargets =
+			{
+				{ Point{ 0, 0 }, 0 },
+			};
+			stageData.keys =
+			{
+				{ Point{ 1, 1 }, RoomData::KeyColor::Gold },
+			};
+			return true;
+		}
+		else if (stageNo == 1)
+		{
+			stageData.mapSize = Size{ 3, 3 };
+			stageData.rooms =
+			{
+				RoomData{ FromEnum(RoomData::Route::Down)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::Right)        , FromEnum(RoomData::Route::Right) }, RoomData{ FromEnum(RoomData::Route::DownLeft)  , FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None)  }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRight)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None)  }, RoomData{ FromEnum(RoomData::Route::UpLeft)    , FromEnum(RoomData::Route::None) },
+			};
+			stageData.startRoom = Point{ 0, 1 };
+			stageData.rescueTargets =
+			{
+				{ Point{ 1, 0 }, 0 },
+			};
+			stageData.keys =
+			{
+				{ Point{ 1, 2 }, RoomData::KeyColor::Gold },
+			};
+			stageData.enemies =
+			{
+				{ Point{ 2, 0 }, EnemyMoveType::UpDown, RoomData::Route::Up },
+			};
+			return true;
+		}
+		else if (stageNo == 2)
+		{
+			stageData.mapSize = Size{ 6, 5 };
+			stageData.rooms =
+			{
+				RoomData{ FromEnum(RoomData::Route::Right)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::Left) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightLeft)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft)   , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::Down)      , FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::RightDown)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::All)          , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft)     , FromEnum(RoomData::Route::Down) }, RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft)   , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRight)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft) , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDown)    , FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpDown)     , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightDown)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::All)          , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRight)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRightLeft)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)       , FromEnum(RoomData::Route::Left) }, RoomData{ FromEnum(RoomData::Route::Right)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)    , FromEnum(RoomData::Route::None) },
+			};
+			stageData.startRoom = Point{ 2, 2 };
+			stageData.rescueTargets =
+			{
+				{ Point{ 0, 0 }, 0 },
+				{ Point{ 3, 4 }, 1 },
+				{ Point{ 3, 2 }, 2 },
+			};
+			stageData.keys =
+			{
+				{ Point{ 0, 1 }, RoomData::KeyColor::Gold },
+				{ Point{ 0, 4 }, RoomData::KeyColor::Gold },
+				{ Point{ 5, 0 }, RoomData::KeyColor::Gold },
+			};
+			stageData.enemies =
+			{
+				{ Point{ 4, 0 }, EnemyMoveType::UpDown, RoomData::Route::Up },
+				{ Point{ 1, 0 }, EnemyMoveType::LeftRight, RoomData::Route::Right },
+				{ Point{ 5, 3 }, EnemyMoveType::LeftRight, RoomData::Route::Left },
+			};
+			return true;
+		}
+		else if (stageNo == 3)
+		{
+			stageData.mapSize = Size{ 5, 4 };
+			stageData.rooms =
+			{
+				RoomData{ FromEnum(RoomData::Route::RightDown)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightLeft)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft)  , FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRightDown), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::DownLeft) , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRight)      , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDownLeft), FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpDown)     , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpRight)  , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightDownLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpDown)    , FromEnum(RoomData::Route::None) },
+				RoomData{ FromEnum(RoomData::Route::UpRight)    , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::RightLeft), FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)       , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::Right)        , FromEnum(RoomData::Route::None) }, RoomData{ FromEnum(RoomData::Route::UpLeft)    , FromEnum(RoomData::Route::Up)   },
+			};
+			stageData.startRoom = Point{ 0, 3 };
+			stageData.rescueTargets =
+			{
+				{ Point{ 0, 0 }, 0 },
+				{ Point{ 3, 3 }, 1 },
+			};
+			stageData.keys =
+			{
+				{ Point{ 1, 1 }, RoomData::KeyColor::Gold },
+			};
+			stageData.enemies =
+			{
+				{ Point{ 2, 0 }, EnemyMoveType::Patrol, RoomData::Route::Right, { Point{ 4, 0 }, Point{ 3, 1 }, Point{ 2, 0 } } },
+				{ Point{ 2, 3 }, EnemyMoveType::Guard, RoomData::Route::None, {}, 1 },
+				{ Point{ 4, 2 }, EnemyMoveType::Chase, RoomData::Route::None },
+			};
+			return true;
+		}
+
+		DEBUG_BREAK(true); // 存在しないステージ
+		return false;
+	}
+}
@@ -0,0 +1,57 @@
+﻿#pragma once
+#ifndef BNSCUP_STAGEDATA_H_
+#define BNSCUP_STAGEDATA_H_
+
+#include <Siv3D.hpp>
+#include "../Map/RoomData.h"
+
+namespace bnscup
+{
+	enum class EnemyMoveType : uint8
+	{
+		UpDown,		// 上下に往復
+		LeftRight,	// 左右に往復
+		Chase,		// プレイヤーを追いかける
+		Patrol,		// 巡回地点を順番に回る
+		Guard,		// 持ち場の近くに来たプレイヤーだけを追いかける
+	};
+
+	struct RescueTargetData
+	{
+		Point pos;
+		int32 look;
+	};
+
+	struct KeyData
+	{
+		Point pos;
+		RoomData::KeyColor color;	// 同じ色の扉を開けられる
+	};
+
+	struct EnemyData
+	{
+		Point pos;
+		EnemyMoveType moveType;
+		RoomData::Route moveDirection;
+		Array<Point> waypoints;	// Patrol の巡回地点
+		int32 guardRange;		// Guard が追いかけ始める距離（手数）
+	};
+
+	// ステージ構成（描画、音に依存しないデータのみ）
+	struct StageData
+	{
+		AssetName tilesetName;
+		int32 chipSize;
+		Size mapSize;
+		Array<RoomData> rooms;
+		Point startRoom;
+		Array<RescueTargetData> rescueTargets;
+		Array<KeyData> keys;
+		Array<EnemyData> enemies;
+	};
+
+	int32 GetStageCount();
+	bool CreateStageData(int32 stageNo, StageData& stageData);
+}
+
+#endif // !BNSCUP_STAGEDATA_H_
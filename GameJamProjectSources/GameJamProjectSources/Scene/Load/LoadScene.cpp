@@ -1,6 +1,9 @@
 ﻿#include "LoadScene.h"
 #include "../../Common/Common.h"
 #include "../../AssetRegister/AssetRegister.h"
+#include "../../Sound/SoundManager.h"
+#include "../../Text/TextLayout.h"
+#include "../../Text/GlyphPrewarm.h"
 #include "../Game/Map/MapData.h"
 
 namespace bnscup
@@ -43,6 +46,7 @@ namespace bnscup
 			RegistWait,
 			LoadAsync,
 			LoadWait,
+			Prewarm,
 			End,
 		};
 
@@ -88,7 +92,10 @@ namespace bnscup
 		{
 		case Step::RegistAsync:
 		{
-			// 先に登録済みを破棄
+			// 先に登録済みを破棄（鳴っている音と並べた文字も手放してから）
+			SoundManager::ReleaseSceneSounds();
+			TextLayoutCache::Clear();
+			GlyphPrewarm::Clear();
 			m_pSceneData->pAssetRegister->unregist();
 			m_pSceneData->pAssetRegister->reset();
 
@@ -160,6 +167,13 @@ namespace bnscup
 					}
 				}
 			}
+			m_step = Step::Prewarm;
+			[[fallthrough]];
+		}
+		case Step::Prewarm:
+		{
+			// シーンで使う文字を先に描いておく（ゲーム中に描くと引っかかる）
+			GlyphPrewarm::Prewarm(m_pSceneData->nextScene);
 			m_step = Step::End;
 			[[fallthrough]];
 		}
@@ -17,11 +17,17 @@ namespace bnscup
 	};
 
 	class AssetRegister;
+	class SceneArena;
+	class FixedTimestep;
+	struct ReplayPlayback;
 	struct SceneData
 	{
 		int32 stageNo;
 		SceneKey nextScene;
 		AssetRegister* pAssetRegister;
+		SceneArena* pSceneArena;
+		const FixedTimestep* pTimestep;
+		ReplayPlayback* pReplayPlayback;
 	};
 
 	using GameApp = SceneManager<SceneKey, SceneData>;
@@ -1,6 +1,7 @@
 ﻿#include "StageSelectScene.h"
 #include "../../Common/Common.h"
 #include "StageSelectView.h"
+#include "../../Sound/SoundManager.h"
 
 namespace bnscup
 {
@@ -25,7 +26,7 @@ namespace bnscup
 		bool m_isEnd;
 
 		StageSelectView m_stageSelectView;
-		Audio m_stageSelectBGM;
+		SoundId m_stageSelectBGM;
 	};
 
 	//==================================================
@@ -35,12 +36,10 @@ namespace bnscup
 		, m_isEnd{ false }
 		, m_stageSelectView{}
 		, m_stageNo{ -1 }
-		, m_stageSelectBGM{}
+		, m_stageSelectBGM{ INVALID_SOUND_ID }
 	{
-		m_stageSelectBGM = AudioAsset(U"sd_bgm_stageselect");
-		m_stageSelectBGM.setLoop(true);
-		m_stageSelectBGM.setVolume(0.1);
-		m_stageSelectBGM.play();
+		m_stageSelectBGM = SoundManager::Register(U"sd_bgm_stageselect", SoundCategory::BGM, 0, 0.1);
+		SoundManager::PlayBGM(m_stageSelectBGM);
 	}
 
 	StageSelectScene::Impl::~Impl()
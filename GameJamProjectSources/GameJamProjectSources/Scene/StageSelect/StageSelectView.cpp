@@ -1,6 +1,9 @@
 ﻿#include "StageSelectView.h"
 #include "../../Common/Common.h"
 #include "../../Button/Button.h"
+#include "../../Text/TextLayout.h"
+#include "../../Text/TextTable.h"
+#include "../Game/Simulation/StageData.h"
 
 namespace
 {
@@ -28,6 +31,16 @@ namespace
 		ROUNDRECT_BASE.x + 50, ROUNDRECT_BASE.y + 50,
 		200, 100
 	};
+
+	// ステージのボタンを並べてスクロールする範囲
+	static const RectF RECT_STAGE_GRID =
+	{
+		RECT_STAGE_BUTTON.x, RECT_STAGE_BUTTON.y,
+		1040, 600
+	};
+
+	constexpr double STAGE_BUTTON_MARGIN = 10.0;
+	constexpr double SCROLL_SPEED = 60.0;	// ホイール1段で動かす量
 }
 
 namespace bnscup
@@ -37,11 +50,21 @@ namespace bnscup
 		: m_pPlayGameButton{ nullptr }
 		, m_pReturnTitleButton{ nullptr }
 		, m_selectStageNo{}
-		, m_pStageButtons{}
+		, m_stageCount{ 0 }
+		, m_columnCount{ 1 }
+		, m_scrollY{ 0.0 }
+		, m_maxScrollY{ 0.0 }
+		, m_stageSlots{}
+		, m_thumbnails{}
 		, m_playButtonFont{}
+		, m_stageNoFont{}
+		, m_pPlayLayout{ nullptr }
 		, m_returnMarkIcon{}
+		, m_layer{ Rect{ 0, 0, static_cast<int32>(WINDOW_SIZE_W), static_cast<int32>(WINDOW_SIZE_H) } }
 	{
 		createDisp();
+		// 最初の update() より前のフェードイン中にも描けるようにしておく
+		m_layer.refresh([this]() { drawLayer(); });
 	}
 
 	StageSelectView::~StageSelectView()
@@ -58,27 +81,58 @@ namespace bnscup
 		{
 			m_pReturnTitleButton->update();
 		}
-		for (size_t i : step(m_pStageButtons.size()))
+
+		// スクロール（並べる範囲にカーソルがあるときだけ）
+		if (RECT_STAGE_GRID.intersects(Cursor::PosF()))
+		{
+			const double wheel = Mouse::Wheel();
+			const double scrollY = Clamp(m_scrollY + wheel * SCROLL_SPEED, 0.0, m_maxScrollY);
+			if (scrollY != m_scrollY)
+			{
+				m_scrollY = scrollY;
+				layoutStageSlots();
+				m_layer.markDirty();
+			}
+		}
+
+		// 縮小画像ができたら描き直す
+		if (m_thumbnails.update())
+		{
+			m_layer.markDirty();
+		}
+
+		const int32 prevSelectStageNo = m_selectStageNo;
+		for (auto& slot : m_stageSlots)
 		{
-			auto* pButton = m_pStageButtons[i].get();
-			pButton->update();
-			if (pButton->isSelected(Button::Sounds::Select))
+			slot.pButton->update();
+			if (slot.pButton->isSelected(Button::Sounds::Select))
 			{
-				m_selectStageNo = static_cast<int32>(i);
+				m_selectStageNo = slot.stageNo;
 			}
 		}
+
+		// 見た目が変わるのは選んでいるステージとスクロール位置だけ
+		if (m_selectStageNo != prevSelectStageNo)
+		{
+			m_layer.markDirty();
+		}
+		m_layer.refresh([this]() { drawLayer(); });
 	}
 
 	void StageSelectView::draw() const
+	{
+		m_layer.draw();
+	}
+
+	void StageSelectView::drawLayer() const
 	{
 		ROUNDRECT_BASE.draw(Palette::Darkkhaki).drawFrame(2.0, Palette::Khaki);
 
 		if (m_pPlayGameButton)
 		{
 			const auto& rect = m_pPlayGameButton->getRect();
-			const auto& playText = m_playButtonFont(U"ゲーム開始");
 			rect.rounded(5).draw(Palette::DefaultBackground).drawFrame();
-			playText.drawAt(rect.center());
+			m_pPlayLayout->drawAt(rect.center());
 		}
 
 		if (m_pReturnTitleButton)
@@ -88,17 +142,43 @@ namespace bnscup
 			m_returnMarkIcon.drawAt(rect.center());
 		}
 
-		for (size_t i : step(m_pStageButtons.size()))
+		// ステージのボタン（並べる範囲からはみ出した部分は切り取る）
 		{
-			auto* pButton = m_pStageButtons[i].get();
-			const auto& buttonRect = pButton->getRect();
-			buttonRect.rounded(5).draw(Palette::Palegoldenrod).drawFrame();
-			m_stageNoFont(U"ステージ{}"_fmt(i + 1)).drawAt(buttonRect.center(), Palette::Black);
-			if (i == m_selectStageNo)
+			const ScopedRenderStates2D rasterizer{ RasterizerState::SolidCullNoneScissor };
+			Graphics2D::SetScissorRect(RECT_STAGE_GRID.asRect());
+			for (const auto& slot : m_stageSlots)
 			{
-				buttonRect.rounded(5).drawFrame(1.0, Palette::Blue);
+				if (slot.stageNo < 0 or not(slot.pButton->isEnable()))
+				{
+					continue;
+				}
+				slot.rect.rounded(5).draw(Palette::Palegoldenrod).drawFrame();
+
+				// 上にマップの縮小画像、下に番号
+				const double labelH = 40.0;
+				const RectF thumbnailArea{ slot.rect.x + 4, slot.rect.y + 4, slot.rect.w - 8, slot.rect.h - labelH - 8 };
+				if (const auto* pThumbnail = m_thumbnails.find(slot.stageNo))
+				{
+					pThumbnail->fitted(thumbnailArea.size).drawAt(thumbnailArea.center());
+				}
+				const RectF labelArea{ slot.rect.x, slot.rect.bottomY() - labelH, slot.rect.w, labelH };
+				slot.label.drawAt(labelArea.center(), Palette::Black);
+				if (slot.stageNo == m_selectStageNo)
+				{
+					slot.rect.rounded(5).drawFrame(1.0, Palette::Blue);
+				}
 			}
 		}
+
+		// スクロールバー（全部が収まらないときだけ）
+		if (0.0 < m_maxScrollY)
+		{
+			const double contentH = RECT_STAGE_GRID.h + m_maxScrollY;
+			const double barH = Max(RECT_STAGE_GRID.h * RECT_STAGE_GRID.h / contentH, 20.0);
+			const double barY = RECT_STAGE_GRID.y + (RECT_STAGE_GRID.h - barH) * (m_scrollY / m_maxScrollY);
+			RectF{ RECT_STAGE_GRID.rightX() + 10, RECT_STAGE_GRID.y, 6, RECT_STAGE_GRID.h }.rounded(3).draw(ColorF{ 0.0, 0.2 });
+			RectF{ RECT_STAGE_GRID.rightX() + 10, barY, 6, barH }.rounded(3).draw(Palette::Khaki);
+		}
 	}
 
 	int32 StageSelectView::getSelectStageNo() const
@@ -124,6 +204,48 @@ namespace bnscup
 		return m_pReturnTitleButton->isSelected(Button::Sounds::Cancel);
 	}
 
+	void StageSelectView::layoutStageSlots()
+	{
+		if (m_stageSlots.isEmpty())
+		{
+			return;
+		}
+
+		const double pitchX = RECT_STAGE_BUTTON.w + STAGE_BUTTON_MARGIN;
+		const double pitchY = RECT_STAGE_BUTTON.h + STAGE_BUTTON_MARGIN;
+		const int32 slotCount = static_cast<int32>(m_stageSlots.size());
+		const int32 firstStageNo = static_cast<int32>(m_scrollY / pitchY) * m_columnCount;
+
+		for (int32 stageNo = firstStageNo; stageNo < (firstStageNo + slotCount); ++stageNo)
+		{
+			auto& slot = m_stageSlots[stageNo % slotCount];
+			if (m_stageCount <= stageNo)
+			{
+				slot.stageNo = -1;
+				slot.pButton->setEnable(false);
+				continue;
+			}
+
+			// 受け持ちが変わったボタンだけ文字を作り直す
+			slot.stageNo = stageNo;
+			if (slot.labelText.update(stageNo + 1))
+			{
+				slot.label.build(m_stageNoFont, slot.labelText.get());
+			}
+			// 縮小画像は見えるようになってから作り始める（待たない）
+			m_thumbnails.request(stageNo);
+
+			const int32 column = stageNo % m_columnCount;
+			const int32 row = stageNo / m_columnCount;
+			slot.rect = RECT_STAGE_BUTTON.movedBy(Vec2{ column * pitchX, row * pitchY - m_scrollY });
+
+			// 当たり判定は見えている部分だけ
+			const RectF visibleRect = slot.rect.getOverlap(RECT_STAGE_GRID);
+			slot.pButton->getRect() = visibleRect;
+			slot.pButton->setEnable(not(visibleRect.isEmpty()));
+		}
+	}
+
 	void StageSelectView::createDisp()
 	{
 		// フォントの設定
@@ -140,15 +262,29 @@ namespace bnscup
 			DEBUG_BREAK(m_returnMarkIcon.isEmpty());
 		}
 
-		// ステージ選択ボタン
-		for (int32 i : step(3))
+		// ステージ選択ボタン（見えている行と、スクロール中に半分見える1行の分だけ作る）
 		{
-			auto* pButton = new Button(RECT_STAGE_BUTTON.movedBy(Vec2{ i * (RECT_STAGE_BUTTON.size.x + 10.0), 0.0}));
-			m_pStageButtons.emplace_back(pButton);
+			const double pitchX = RECT_STAGE_BUTTON.w + STAGE_BUTTON_MARGIN;
+			const double pitchY = RECT_STAGE_BUTTON.h + STAGE_BUTTON_MARGIN;
+			m_stageCount = GetStageCount();
+			m_columnCount = Max(static_cast<int32>((RECT_STAGE_GRID.w + STAGE_BUTTON_MARGIN) / pitchX), 1);
+
+			const int32 rowCount = (m_stageCount + m_columnCount - 1) / m_columnCount;
+			m_maxScrollY = Max(rowCount * pitchY - STAGE_BUTTON_MARGIN - RECT_STAGE_GRID.h, 0.0);
+
+			const int32 visibleRowCount = static_cast<int32>(Math::Ceil(RECT_STAGE_GRID.h / pitchY)) + 1;
+			const int32 slotCount = Min(visibleRowCount * m_columnCount, m_stageCount);
+			m_stageSlots.reserve(slotCount);
+			for ([[maybe_unused]] int32 i : step(slotCount))
+			{
+				m_stageSlots.push_back(StageSlot{ std::make_unique<Button>(RECT_STAGE_BUTTON), -1, RECT_STAGE_BUTTON, FormattedText<int32>{ TextId::StageNo }, TextLayout{} });
+			}
+			layoutStageSlots();
 		}
 
 		// ゲーム開始ボタンの作成
 		{
+			m_pPlayLayout = TextLayoutCache::Get(m_playButtonFont, TextTable::Get(TextId::StageSelectPlay));
 			auto* pPlayButton = new Button(RECT_PLAY_GAME_BUTTON);
 			m_pPlayGameButton.reset(pPlayButton);
 		}
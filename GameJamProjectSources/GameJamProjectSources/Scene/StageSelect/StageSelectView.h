@@ -3,10 +3,21 @@
 #define BNSCUP_STAGESELECTVIEW_H_
 
 #include <Siv3D.hpp>
+#include "../../RetainedLayer/RetainedLayer.h"
+#include "../../Text/TextLayout.h"
+#include "../../Text/TextTable.h"
+#include "StageThumbnailCache.h"
 
 namespace bnscup
 {
 	class Button;
+
+	/**
+	 * @brief ステージ選択画面
+	 * @details ステージのボタンは見えている分（＋1行）だけ作っておき、スクロールで見えるステージが
+	 *          変わったら空いたボタンに割り当て直す。ステージ番号 % ボタンの数 でボタンを決めるので、
+	 *          1行スクロールしても割り当て直すのは1行分だけで済む。ステージ数によらず手間は変わらない。
+	 */
 	class StageSelectView
 	{
 	public:
@@ -25,18 +36,41 @@ namespace bnscup
 
 		void createDisp();
 
+		// スクロール位置から各ボタンの位置と受け持つステージを決め直す
+		void layoutStageSlots();
+
+		// 層に描く中身（選んでいるステージかスクロール位置が変わったときだけ呼ぶ）
+		void drawLayer() const;
+
 	private:
 
+		// ステージのボタン1つ分（使い回す）
+		struct StageSlot
+		{
+			std::unique_ptr<Button> pButton;
+			int32 stageNo;		// 受け持っているステージ（-1 なら空き）
+			RectF rect;			// 見えていない部分も含めた位置
+			FormattedText<int32> labelText;
+			TextLayout label;	// 受け持ちが変わったときだけ作り直す
+		};
+
 		Font m_playButtonFont;
 		Font m_stageNoFont;
+		const TextLayout* m_pPlayLayout;
 		Texture m_returnMarkIcon;
 
 		int32 m_selectStageNo;
-		Array<std::unique_ptr<Button>> m_pStageButtons;
+		int32 m_stageCount;
+		int32 m_columnCount;
+		double m_scrollY;
+		double m_maxScrollY;
+		Array<StageSlot> m_stageSlots;
+		StageThumbnailCache m_thumbnails;
 
 		std::unique_ptr<Button> m_pPlayGameButton;
 		std::unique_ptr<Button> m_pReturnTitleButton;
 
+		RetainedLayer m_layer;
 	};
 }
 
@@ -0,0 +1,303 @@
+﻿#include "StageThumbnailCache.h"
+#include "../../Common/Common.h"
+#include "../Game/Map/MapData.h"
+#include "../Game/Map/MapView.h"
+#include "../Game/Map/RoomData.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		static const FilePath CACHE_DIRECTORY = U"cache/thumbnails/";
+
+		// 描き方を変えたら上げる（古いキャッシュを使わないように）
+		constexpr uint64 THUMBNAIL_VERSION = 2;
+
+		// FNV-1a
+		constexpr uint64 HASH_OFFSET_BASIS = 14695981039346656037ull;
+		constexpr uint64 HASH_PRIME = 1099511628211ull;
+
+		void HashValue(uint64& hash, uint64 value)
+		{
+			for (int32 i : step(8))
+			{
+				hash ^= static_cast<uint8>(value >> (i * 8));
+				hash *= HASH_PRIME;
+			}
+		}
+
+		// 縮小画像の見た目に関わるもの（部屋の形、扉と色、タイルセット）だけのハッシュ
+		uint64 ComputeThumbnailHash(const StageData& stageData)
+		{
+			static const RoomData::Route ROUTE_TABLE[] =
+			{
+				RoomData::Route::Up,
+				RoomData::Route::Right,
+				RoomData::Route::Down,
+				RoomData::Route::Left,
+			};
+
+			uint64 hash = HASH_OFFSET_BASIS;
+			HashValue(hash, THUMBNAIL_VERSION);
+			for (const auto ch : stageData.tilesetName)
+			{
+				HashValue(hash, static_cast<uint64>(ch));
+			}
+			HashValue(hash, static_cast<uint64>(stageData.chipSize));
+			HashValue(hash, static_cast<uint64>(stageData.mapSize.x));
+			HashValue(hash, static_cast<uint64>(stageData.mapSize.y));
+			for (const auto& room : stageData.rooms)
+			{
+				uint64 routeBits = 0;
+				uint64 lockColors = 0;
+				for (size_t i : step(std::size(ROUTE_TABLE)))
+				{
+					if (room.canPassable(ROUTE_TABLE[i]))
+					{
+						routeBits |= (1ull << i);
+					}
+					lockColors |= static_cast<uint64>(FromEnum(room.getLockColor(ROUTE_TABLE[i]))) << (i * 8);
+				}
+				HashValue(hash, routeBits);
+				HashValue(hash, room.getLockBits());
+				HashValue(hash, lockColors);
+			}
+			return hash;
+		}
+
+		FilePath GetCachePath(uint64 hash)
+		{
+			return U"{}{:016X}.png"_fmt(CACHE_DIRECTORY, hash);
+		}
+	}
+
+	StageThumbnailCache::StageThumbnailCache()
+		: m_entries{}
+		, m_waitingStageNos{}
+		, m_loadTasks{}
+		, m_renderQueue{}
+		, m_pendingSaves{}
+		, m_savedHashes{}
+		, m_saveTasks{}
+		, m_useCounter{ 0 }
+		, m_stats{}
+	{
+		m_loadTasks.reserve(MAX_TASK_COUNT);
+	}
+
+	StageThumbnailCache::~StageThumbnailCache()
+	{
+		// 読み出していないものもここで保存に回す
+		for (const auto& pendingSave : m_pendingSaves)
+		{
+			startSave(pendingSave);
+		}
+		m_pendingSaves.clear();
+
+		// 保存中のものは書き終わるまで待つ（途中のファイルを残さない）
+		for (auto& task : m_saveTasks)
+		{
+			if (task.isValid())
+			{
+				task.wait();
+			}
+		}
+#ifdef _DEBUG
+		Logger << U"stage thumbnail: disk {}, render {}"_fmt(m_stats.diskHitCount, m_stats.renderCount);
+#endif // _DEBUG
+	}
+
+	void StageThumbnailCache::request(int32 stageNo)
+	{
+		++m_useCounter;
+		auto it = m_entries.find(stageNo);
+		if (it != m_entries.end())
+		{
+			it->second.lastUseCount = m_useCounter;
+			return;
+		}
+
+		m_entries.emplace(stageNo, Entry{ Texture{}, m_useCounter });
+		m_waitingStageNos.push_back(stageNo);
+		if (CAPACITY < m_entries.size())
+		{
+			evict();
+		}
+		startTasks();
+	}
+
+	bool StageThumbnailCache::update()
+	{
+		bool isUpdated = false;
+
+		// 終わったワーカーの結果を受け取る
+		for (auto it = m_loadTasks.begin(); it != m_loadTasks.end();)
+		{
+			if (not(it->isReady()))
+			{
+				++it;
+				continue;
+			}
+			LoadResult result = it->get();
+			it = m_loadTasks.erase(it);
+
+			auto entryIt = m_entries.find(result.stageNo);
+			if (entryIt == m_entries.end())
+			{
+				// 待っている間に捨てられた
+				continue;
+			}
+			if (not(result.isValid))
+			{
+				// 作れないステージは出さない
+				m_entries.erase(entryIt);
+				continue;
+			}
+			if (result.image.isEmpty())
+			{
+				m_renderQueue.push_back(std::move(result));
+				continue;
+			}
+			entryIt->second.texture = Texture{ result.image };
+			m_stats.diskHitCount++;
+			isUpdated = true;
+		}
+
+		// キャッシュが無かったものは1フレームに1枚だけ描く
+		if (not(m_renderQueue.isEmpty()))
+		{
+			LoadResult result = std::move(m_renderQueue.front());
+			m_renderQueue.pop_front();
+			if (m_entries.contains(result.stageNo))
+			{
+				renderThumbnail(result);
+				isUpdated = true;
+			}
+		}
+
+		// 前のフレームまでに描いたものを1枚だけ読み出して保存に回す（描いたフレームのうちに読むと描画を待つことになる）
+		if (not(m_pendingSaves.isEmpty()) and m_pendingSaves.front().renderFrame < static_cast<uint64>(Scene::FrameCount()))
+		{
+			startSave(m_pendingSaves.front());
+			m_pendingSaves.pop_front();
+		}
+
+		// 書き終わった保存を片付ける
+		m_saveTasks.remove_if([](const AsyncTask<bool>& task) { return task.isReady(); });
+
+		startTasks();
+		return isUpdated;
+	}
+
+	const Texture* StageThumbnailCache::find(int32 stageNo) const
+	{
+		auto it = m_entries.find(stageNo);
+		if (it == m_entries.end() or it->second.texture.isEmpty())
+		{
+			return nullptr;
+		}
+		return &(it->second.texture);
+	}
+
+	const StageThumbnailCache::Stats& StageThumbnailCache::getStats() const
+	{
+		return m_stats;
+	}
+
+	void StageThumbnailCache::startTasks()
+	{
+		while (m_loadTasks.size() < MAX_TASK_COUNT and not(m_waitingStageNos.isEmpty()))
+		{
+			const int32 stageNo = m_waitingStageNos.front();
+			m_waitingStageNos.pop_front();
+			if (not(m_entries.contains(stageNo)))
+			{
+				continue;
+			}
+			m_loadTasks.push_back(Async(LoadTask, stageNo));
+		}
+	}
+
+	void StageThumbnailCache::renderThumbnail(LoadResult& result)
+	{
+		const auto& stageData = result.stageData;
+		MapData mapData{ stageData.rooms, stageData.tilesetName, stageData.mapSize.x, stageData.mapSize.y, stageData.chipSize };
+		const MapView mapView{ &mapData };
+
+		// 部屋は 5x5 チップ
+		const Size mapPixelSize = stageData.mapSize * (stageData.chipSize * 5);
+		if (mapPixelSize.x <= 0 or mapPixelSize.y <= 0)
+		{
+			return;
+		}
+		const double scale = Min(static_cast<double>(THUMBNAIL_SIZE) / Max(mapPixelSize.x, mapPixelSize.y), 1.0);
+		const Size thumbnailSize{ Max(static_cast<int32>(mapPixelSize.x * scale), 1), Max(static_cast<int32>(mapPixelSize.y * scale), 1) };
+
+		// 縮小した大きさのテクスチャへ直接描き、そのまま表示に使う
+		const RenderTexture renderTexture{ thumbnailSize };
+		{
+			const ScopedRenderTarget2D target{ renderTexture.clear(Palette::Black) };
+			const ScopedRenderStates2D sampler{ SamplerState::ClampLinear };
+			const Transformer2D transformer{ Mat3x2::Scale(scale) };
+			mapView.draw();
+		}
+		m_entries[result.stageNo].texture = renderTexture;
+		m_stats.renderCount++;
+
+		// 同じ内容のステージは1回だけ保存する
+		if (m_savedHashes.insert(result.hash).second)
+		{
+			m_pendingSaves.push_back(PendingSave{ result.hash, renderTexture, static_cast<uint64>(Scene::FrameCount()) });
+		}
+	}
+
+	void StageThumbnailCache::startSave(const PendingSave& pendingSave)
+	{
+		Image image;
+		pendingSave.renderTexture.readAsImage(image);
+
+		// 保存はワーカーで（書き終わりは待たない）
+		const FilePath path = GetCachePath(pendingSave.hash);
+		m_saveTasks.push_back(Async([image = std::move(image), path]()
+		{
+			FileSystem::CreateDirectories(CACHE_DIRECTORY);
+			return image.save(path);
+		}));
+	}
+
+	void StageThumbnailCache::evict()
+	{
+		// 一番長く使われていないものを捨てる
+		auto oldestIt = m_entries.end();
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+		{
+			if (oldestIt == m_entries.end() or it->second.lastUseCount < oldestIt->second.lastUseCount)
+			{
+				oldestIt = it;
+			}
+		}
+		if (oldestIt != m_entries.end())
+		{
+			m_entries.erase(oldestIt);
+		}
+	}
+
+	StageThumbnailCache::LoadResult StageThumbnailCache::LoadTask(int32 stageNo)
+	{
+		LoadResult result;
+		result.stageNo = stageNo;
+		if (not(CreateStageData(stageNo, result.stageData)))
+		{
+			return result;
+		}
+		result.isValid = true;
+		result.hash = ComputeThumbnailHash(result.stageData);
+
+		const FilePath path = GetCachePath(result.hash);
+		if (FileSystem::Exists(path))
+		{
+			result.image = Image{ path };
+		}
+		return result;
+	}
+}
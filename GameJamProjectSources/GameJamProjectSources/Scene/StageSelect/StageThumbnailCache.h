@@ -0,0 +1,93 @@
+﻿#pragma once
+#ifndef BNSCUP_STAGETHUMBNAILCACHE_H_
+#define BNSCUP_STAGETHUMBNAILCACHE_H_
+
+#include <Siv3D.hpp>
+#include "../Game/Simulation/StageData.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief ステージ選択で見せるマップの縮小画像
+	 * @details 見えるようになったステージだけ request() で作り始め、待たずに戻る。
+	 *          ステージの生成、内容のハッシュ、ディスクのキャッシュ（ハッシュをファイル名にした png）の読み込みと
+	 *          保存はワーカースレッドで行う。キャッシュが無い場合だけ、メインスレッドで MapView を使って
+	 *          1フレームに1枚ずつ描く（テクスチャへの描画はメインスレッドでしかできないため）。
+	 *          描いた RenderTexture はそのまま表示に使い、保存のための読み出しは後のフレームで1枚ずつ行う。
+	 */
+	class StageThumbnailCache
+	{
+	public:
+
+		static constexpr size_t CAPACITY = 128;		// 持っておく画像の数
+		static constexpr size_t MAX_TASK_COUNT = 4;	// 同時に動かすワーカーの数
+		static constexpr int32 THUMBNAIL_SIZE = 96;	// 長い辺の大きさ
+
+		struct Stats
+		{
+			size_t diskHitCount = 0;	// ディスクのキャッシュから読んだ数
+			size_t renderCount = 0;		// 描いて作った数
+		};
+
+	public:
+
+		explicit StageThumbnailCache();
+		virtual ~StageThumbnailCache();
+
+		// 見えるようになったステージを知らせる（まだ無ければ作り始める）
+		void request(int32 stageNo);
+
+		// 終わった読み込みを受け取る（フレームに1回）。新しく使えるようになった画像があれば true
+		bool update();
+
+		// まだできていなければ nullptr
+		const Texture* find(int32 stageNo) const;
+
+		const Stats& getStats() const;
+
+	private:
+
+		struct Entry
+		{
+			Texture texture;
+			uint64 lastUseCount;	// 最後に request() された順（古いものから捨てる）
+		};
+
+		struct LoadResult
+		{
+			int32 stageNo = -1;
+			bool isValid = false;	// ステージを作れなかったら false
+			uint64 hash = 0;
+			Image image;			// ディスクから読めた場合のみ
+			StageData stageData;	// 描く必要がある場合のみ使う
+		};
+
+		struct PendingSave
+		{
+			uint64 hash;
+			RenderTexture renderTexture;
+			uint64 renderFrame;		// 描いたフレーム（このフレームのうちは読み出さない）
+		};
+
+		void startTasks();
+		void renderThumbnail(LoadResult& result);
+		void startSave(const PendingSave& pendingSave);
+		void evict();
+
+		static LoadResult LoadTask(int32 stageNo);
+
+	private:
+
+		HashTable<int32, Entry> m_entries;		// 作り始めたステージ（できるまでテクスチャは空）
+		Array<int32> m_waitingStageNos;			// ワーカーに渡す順番待ち
+		Array<AsyncTask<LoadResult>> m_loadTasks;
+		Array<LoadResult> m_renderQueue;		// メインスレッドで描くもの
+		Array<PendingSave> m_pendingSaves;		// 読み出して保存するのを待っているもの
+		HashSet<uint64> m_savedHashes;			// 保存を始めたハッシュ（同じ内容のステージで同じファイルに書かない）
+		Array<AsyncTask<bool>> m_saveTasks;
+		uint64 m_useCounter;
+		Stats m_stats;
+	};
+}
+
+#endif // !BNSCUP_STAGETHUMBNAILCACHE_H_
@@ -1,5 +1,6 @@
 ﻿#include "TitleScene.h"
 #include "TitleView.h"
+#include "../../Sound/SoundManager.h"
 
 namespace bnscup
 {
@@ -29,7 +30,7 @@ namespace bnscup
 		bool m_isEnd;
 
 		TitleView m_titleView;
-		Audio m_titleBGM;
+		SoundId m_titleBGM;
 	};
 
 	//==================================================
@@ -39,12 +40,10 @@ namespace bnscup
 		, m_nextSceneKey{ SceneKey::Title }
 		, m_isEnd{ false }
 		, m_titleView{}
-		, m_titleBGM{}
+		, m_titleBGM{ INVALID_SOUND_ID }
 	{
-		m_titleBGM = AudioAsset(U"sd_bgm_title");
-		m_titleBGM.setLoop(true);
-		m_titleBGM.setVolume(0.05);
-		m_titleBGM.play();
+		m_titleBGM = SoundManager::Register(U"sd_bgm_title", SoundCategory::BGM, 0, 0.05);
+		SoundManager::PlayBGM(m_titleBGM);
 	}
 
 	TitleScene::Impl::~Impl()
@@ -1,6 +1,8 @@
 ﻿#include "TitleView.h"
 #include "../../Common/Common.h"
 #include "../../Button/Button.h"
+#include "../../Text/TextLayout.h"
+#include "../../Text/TextTable.h"
 
 namespace
 {
@@ -24,8 +26,14 @@ namespace bnscup
 		, m_pExitButton{ nullptr }
 		, m_logoFont{}
 		, m_buttonFont{}
+		, m_pLogoLayout{ nullptr }
+		, m_pStageSelectLayout{ nullptr }
+		, m_pExitLayout{ nullptr }
+		, m_layer{ Rect{ 0, 0, static_cast<int32>(WINDOW_SIZE_W), static_cast<int32>(WINDOW_SIZE_H) } }
 	{
 		createDisp();
+		// 最初の update() より前のフェードイン中にも描けるようにしておく
+		m_layer.refresh([this]() { drawLayer(); });
 	}
 
 	TitleView::~TitleView()
@@ -42,17 +50,29 @@ namespace bnscup
 		{
 			m_pExitButton->update();
 		}
+
+		// 見た目が変わったボタンがあれば描き直す
+		if ((m_pToStageSelectButton and m_pToStageSelectButton->isVisualChanged())
+			or (m_pExitButton and m_pExitButton->isVisualChanged()))
+		{
+			m_layer.markDirty();
+		}
+		m_layer.refresh([this]() { drawLayer(); });
 	}
 
 	void TitleView::draw() const
+	{
+		m_layer.draw();
+	}
+
+	void TitleView::drawLayer() const
 	{
 		// ステージ選択ボタン
 		if (m_pToStageSelectButton)
 		{
-			const auto& selectText = m_buttonFont(U"ステージ選択");
 			const auto& buttonRect = m_pToStageSelectButton->getRect();
-			selectText.draw(buttonRect.x, buttonRect.y + (buttonRect.h - selectText.region().h) * 0.5);
-			if (buttonRect.mouseOver())
+			m_pStageSelectLayout->draw(Vec2{ buttonRect.x, buttonRect.y + (buttonRect.h - m_pStageSelectLayout->getSize().y) * 0.5 });
+			if (m_pToStageSelectButton->isHover())
 			{
 				buttonRect.drawFrame();
 			}
@@ -61,10 +81,9 @@ namespace bnscup
 		// ゲーム終了ボタン
 		if (m_pExitButton)
 		{
-			const auto& selectText = m_buttonFont(U"ゲーム終了");
 			const auto& buttonRect = m_pExitButton->getRect();
-			selectText.draw(buttonRect.x, buttonRect.y + (buttonRect.h - selectText.region().h) * 0.5);
-			if (buttonRect.mouseOver())
+			m_pExitLayout->draw(Vec2{ buttonRect.x, buttonRect.y + (buttonRect.h - m_pExitLayout->getSize().y) * 0.5 });
+			if (m_pExitButton->isHover())
 			{
 				buttonRect.drawFrame();
 			}
@@ -72,10 +91,9 @@ namespace bnscup
 
 		// ロゴ
 		{
-			const auto& logoText = m_logoFont(bnscup::GAME_TITLE);
-			const auto& region = logoText.region();
+			const auto& region = m_pLogoLayout->getRegion();
 			const double topMargin = 50.0;
-			logoText.drawAt(Scene::CenterF().x, region.centerY() + topMargin);
+			m_pLogoLayout->drawAt(Vec2{ Scene::CenterF().x, region.centerY() + topMargin });
 		}
 	}
 
@@ -107,6 +125,13 @@ namespace bnscup
 			DEBUG_BREAK(m_buttonFont.isEmpty());
 		}
 
+		// 文字は変わらないので並べた結果を使い回す
+		{
+			m_pLogoLayout = TextLayoutCache::Get(m_logoFont, bnscup::GAME_TITLE);
+			m_pStageSelectLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::TitleStageSelect));
+			m_pExitLayout = TextLayoutCache::Get(m_buttonFont, TextTable::Get(TextId::TitleExit));
+		}
+
 		// ステージ選択ボタンの作成
 		{
 			auto* pStageSelectButton = new Button(RECT_STAGE_SELECT_BUTTON);
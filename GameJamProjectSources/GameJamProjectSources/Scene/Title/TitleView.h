@@ -3,10 +3,12 @@
 #define BNSCUP_TITLEVIEW_H_
 
 #include <Siv3D.hpp>
+#include "../../RetainedLayer/RetainedLayer.h"
 
 namespace bnscup
 {
 	class Button;
+	class TextLayout;
 	class TitleView
 	{
 	public:
@@ -24,12 +26,19 @@ namespace bnscup
 
 		void createDisp();
 
+		// 層に描く中身（ボタンの見た目が変わったときだけ呼ぶ）
+		void drawLayer() const;
+
 	private:
 
 		Font m_logoFont;
 		Font m_buttonFont;
+		const TextLayout* m_pLogoLayout;
+		const TextLayout* m_pStageSelectLayout;
+		const TextLayout* m_pExitLayout;
 		std::unique_ptr<Button> m_pToStageSelectButton;
 		std::unique_ptr<Button> m_pExitButton;
+		RetainedLayer m_layer;
 	};
 }
 
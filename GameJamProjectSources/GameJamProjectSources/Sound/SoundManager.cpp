@@ -0,0 +1,263 @@
+﻿#include "SoundManager.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		struct Sound
+		{
+			AssetName assetName;
+			Audio audio;
+			double length;
+			double volume;
+			int32 priority;
+			SoundCategory category;
+			bool isPersistent;
+		};
+
+		struct Voice
+		{
+			SoundId soundId = INVALID_SOUND_ID;
+			double endTime = 0.0;
+			uint32 serial = 0;	// 鳴らし始めた順
+		};
+
+		// 種類ごとの同時に鳴らせる数（SoundCategory の順）
+		size_t g_categoryLimits[] = { 2, 2, 4, 1 };
+		static_assert(std::size(g_categoryLimits) == FromEnum(SoundCategory::Count));
+
+		Array<Sound> g_sounds;
+		std::array<Voice, SoundManager::VOICE_COUNT> g_voices;
+		uint32 g_voiceSerial = 0;
+		double g_clock = 0.0;
+		SoundId g_bgmId = INVALID_SOUND_ID;
+		SoundManager::Stats g_stats;
+
+		bool IsValid(SoundId id)
+		{
+			return (id < g_sounds.size()) and not(g_sounds[id].audio.isEmpty());
+		}
+
+		bool IsBusy(const Voice& voice)
+		{
+			return (voice.soundId != INVALID_SOUND_ID) and (g_clock < voice.endTime);
+		}
+
+		// 止めてよいボイスのうち、最も優先度が低く古いもの
+		Voice* FindVictim(Optional<SoundCategory> category)
+		{
+			Voice* pVictim = nullptr;
+			for (auto& voice : g_voices)
+			{
+				if (not(IsBusy(voice)))
+				{
+					continue;
+				}
+				const auto& sound = g_sounds[voice.soundId];
+				if (category and sound.category != *category)
+				{
+					continue;
+				}
+				if (pVictim == nullptr)
+				{
+					pVictim = &voice;
+					continue;
+				}
+				const auto& victimSound = g_sounds[pVictim->soundId];
+				if (sound.priority < victimSound.priority
+					or (sound.priority == victimSound.priority and voice.serial < pVictim->serial))
+				{
+					pVictim = &voice;
+				}
+			}
+			return pVictim;
+		}
+
+		void StopVoice(Voice& victim)
+		{
+			// playOneShot は1回分だけを止められないので、同じ音がほかのボイスでも鳴っているときは止めずに枠だけ空ける
+			// （止めると関係のないボイスまで途切れる。空けた分は短い効果音の残りが鳴り終わるまで）
+			const SoundId soundId = victim.soundId;
+			victim = Voice{};
+			for (const auto& voice : g_voices)
+			{
+				if (voice.soundId == soundId and IsBusy(voice))
+				{
+					return;
+				}
+			}
+			g_sounds[soundId].audio.stopAllShots();
+		}
+	}
+
+	SoundId SoundManager::Register(AssetNameView assetName, SoundCategory category, int32 priority, double volume, Persistent persistent)
+	{
+		Optional<size_t> freeIndex;
+		for (size_t i = 0; i < g_sounds.size(); ++i)
+		{
+			if (g_sounds[i].audio.isEmpty())
+			{
+				if (not(freeIndex))
+				{
+					freeIndex = i;
+				}
+				continue;
+			}
+			if (g_sounds[i].assetName == assetName)
+			{
+				return static_cast<SoundId>(i);
+			}
+		}
+
+		// 名前から引くのはここだけ
+		Audio audio = AudioAsset(assetName);
+		if (audio.isEmpty())
+		{
+			DEBUG_BREAK(true);
+			return INVALID_SOUND_ID;
+		}
+		Sound sound{ AssetName{ assetName }, audio, audio.lengthSec(), volume, priority, category, static_cast<bool>(persistent) };
+		if (freeIndex)
+		{
+			g_sounds[*freeIndex] = std::move(sound);
+			return static_cast<SoundId>(*freeIndex);
+		}
+		DEBUG_BREAK(INVALID_SOUND_ID <= g_sounds.size());
+		g_sounds.push_back(std::move(sound));
+		return static_cast<SoundId>(g_sounds.size() - 1);
+	}
+
+	void SoundManager::SetCategoryLimit(SoundCategory category, size_t limit)
+	{
+		g_categoryLimits[FromEnum(category)] = Min(limit, VOICE_COUNT);
+	}
+
+	bool SoundManager::Play(SoundId id)
+	{
+		if (not(IsValid(id)))
+		{
+			return false;
+		}
+		const auto& sound = g_sounds[id];
+
+		// 種類ごとの上限
+		size_t categoryCount = 0;
+		for (const auto& voice : g_voices)
+		{
+			if (IsBusy(voice) and g_sounds[voice.soundId].category == sound.category)
+			{
+				categoryCount++;
+			}
+		}
+
+		Voice* pVoice = nullptr;
+		if (g_categoryLimits[FromEnum(sound.category)] <= categoryCount)
+		{
+			pVoice = FindVictim(sound.category);
+		}
+		else
+		{
+			for (auto& voice : g_voices)
+			{
+				if (not(IsBusy(voice)))
+				{
+					pVoice = &voice;
+					break;
+				}
+			}
+			if (pVoice == nullptr)
+			{
+				pVoice = FindVictim(none);
+			}
+		}
+
+		if (pVoice == nullptr)
+		{
+			g_stats.dropCount++;
+			return false;
+		}
+		if (IsBusy(*pVoice))
+		{
+			// 優先度の高い音は止めない。同じ音を止めて鳴らし直しても変わらないのでそのまま鳴らさない
+			if (sound.priority < g_sounds[pVoice->soundId].priority
+				or pVoice->soundId == id)
+			{
+				g_stats.dropCount++;
+				return false;
+			}
+			StopVoice(*pVoice);
+			g_stats.stealCount++;
+		}
+
+		sound.audio.playOneShot(sound.volume);
+		pVoice->soundId = id;
+		pVoice->endTime = g_clock + sound.length;
+		pVoice->serial = ++g_voiceSerial;
+		g_stats.playCount++;
+		return true;
+	}
+
+	void SoundManager::PlayBGM(SoundId id)
+	{
+		if (id == g_bgmId)
+		{
+			return;
+		}
+		StopBGM();
+		if (not(IsValid(id)))
+		{
+			return;
+		}
+		auto& sound = g_sounds[id];
+		sound.audio.setLoop(true);
+		sound.audio.setVolume(sound.volume);
+		sound.audio.play();
+		g_bgmId = id;
+	}
+
+	void SoundManager::StopBGM()
+	{
+		if (IsValid(g_bgmId))
+		{
+			g_sounds[g_bgmId].audio.stop();
+		}
+		g_bgmId = INVALID_SOUND_ID;
+	}
+
+	void SoundManager::Update(double deltaTime)
+	{
+		g_clock += deltaTime;
+	}
+
+	void SoundManager::ReleaseSceneSounds()
+	{
+		for (size_t i = 0; i < g_sounds.size(); ++i)
+		{
+			auto& sound = g_sounds[i];
+			if (sound.isPersistent or sound.audio.isEmpty())
+			{
+				continue;
+			}
+			if (g_bgmId == i)
+			{
+				StopBGM();
+			}
+			sound.audio.stopAllShots();
+			for (auto& voice : g_voices)
+			{
+				if (voice.soundId == i)
+				{
+					voice = Voice{};
+				}
+			}
+			// 空きとして残し、番号は次の登録で使い回す
+			sound = Sound{};
+		}
+	}
+
+	const SoundManager::Stats& SoundManager::GetStats()
+	{
+		return g_stats;
+	}
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+#ifndef BNSCUP_SOUNDMANAGER_H_
+#define BNSCUP_SOUNDMANAGER_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	enum class SoundCategory : uint8
+	{
+		UI,
+		FootStep,
+		Gameplay,
+		BGM,
+
+		Count,
+	};
+
+	using SoundId = uint16;
+	constexpr SoundId INVALID_SOUND_ID = 0xFFFF;
+
+	/**
+	 * @brief 効果音の鳴らし分けをまとめて受け持つ
+	 * @details 音は読み込み後に一度だけ名前から引いて SoundId にしておき、鳴らすときは番号だけを渡す。
+	 *          同時に鳴らせる数（ボイス）は全体と種類ごとに上限があり、
+	 *          あふれた場合は優先度の低い（同じなら古い）ものを止めて鳴らす。止めるのが同じ音なら鳴らさない。
+	 */
+	class SoundManager
+	{
+	public:
+
+		// 全体で同時に鳴らせる数
+		static constexpr size_t VOICE_COUNT = 16;
+
+		// シーンをまたいで残す音（共通パックの音など）
+		using Persistent = YesNo<struct Persistent_tag>;
+
+		struct Stats
+		{
+			size_t playCount = 0;	// 鳴らした回数
+			size_t stealCount = 0;	// ほかの音を止めて鳴らした回数
+			size_t dropCount = 0;	// 上限で鳴らさなかった回数
+		};
+
+	public:
+
+		/**
+		 * @brief 音を登録して番号を返す（同じ名前なら同じ番号）
+		 * @param priority 大きいほど止められにくい
+		 */
+		static SoundId Register(AssetNameView assetName, SoundCategory category, int32 priority, double volume, Persistent persistent = Persistent::No);
+
+		static void SetCategoryLimit(SoundCategory category, size_t limit);
+
+		// 鳴らせなかった場合は false
+		static bool Play(SoundId id);
+
+		// BGM は1つだけでループする。同じものが鳴っていれば何もしない
+		static void PlayBGM(SoundId id);
+		static void StopBGM();
+
+		// ボイスの空きを判定するための時計を進める（フレームに1回）
+		static void Update(double deltaTime);
+
+		// シーンの音をすべて止めて手放す（アセットを破棄する前に呼ぶ）
+		static void ReleaseSceneSounds();
+
+		static const Stats& GetStats();
+	};
+}
+
+#endif // !BNSCUP_SOUNDMANAGER_H_
@@ -0,0 +1,132 @@
+﻿#include "SpriteDrawList.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// 足元の Y は 1/4 ピクセル単位で上位 16bit に入れる（負の座標も扱えるように中央を 0 にする）
+		constexpr double FOOT_Y_SCALE = 4.0;
+		constexpr int32 FOOT_Y_BIAS = 0x8000;
+
+		uint32 MakeSortKey(double footY, uint16 textureSlot)
+		{
+			const int32 y = Clamp(static_cast<int32>(std::floor(footY * FOOT_Y_SCALE)) + FOOT_Y_BIAS, 0, 0xFFFF);
+			return (static_cast<uint32>(y) << 16) | textureSlot;
+		}
+	}
+
+	SpriteDrawList::SpriteDrawList()
+		: m_sprites{}
+		, m_keys{}
+		, m_order{}
+		, m_sortBuffer{}
+		, m_textures{}
+	{
+	}
+
+	SpriteDrawList::~SpriteDrawList()
+	{
+	}
+
+	void SpriteDrawList::reserve(size_t count)
+	{
+		m_sprites.reserve(count);
+		m_keys.reserve(count);
+		m_order.reserve(count);
+		m_sortBuffer.reserve(count);
+	}
+
+	void SpriteDrawList::clear()
+	{
+		// 容量は残して使い回す
+		m_sprites.clear();
+		m_keys.clear();
+		m_order.clear();
+		m_textures.clear();
+	}
+
+	void SpriteDrawList::add(const Texture* pTexture, const RectF& srcRect, const Vec2& pos, double footY, bool isMirror, const ColorF& color)
+	{
+		if (pTexture == nullptr)
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		const uint16 textureSlot = findTextureSlot(pTexture);
+		m_keys.push_back(MakeSortKey(footY, textureSlot));
+		m_order.push_back(static_cast<uint32>(m_sprites.size()));
+		m_sprites.push_back(Sprite{ srcRect, pos, color, textureSlot, isMirror });
+	}
+
+	size_t SpriteDrawList::getCount() const
+	{
+		return m_sprites.size();
+	}
+
+	void SpriteDrawList::sort()
+	{
+		const size_t count = m_order.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// 8bit ずつの LSD 基数ソート（安定なので同じキーは積んだ順のまま）
+		m_sortBuffer.resize(count);
+		uint32* pSrc = m_order.data();
+		uint32* pDst = m_sortBuffer.data();
+		for (uint32 shift = 0; shift < 32; shift += 8)
+		{
+			size_t offsets[256] = {};
+			for (size_t i = 0; i < count; ++i)
+			{
+				offsets[(m_keys[pSrc[i]] >> shift) & 0xFF]++;
+			}
+			// 全部同じ桁ならこの桁は並べ替えなくてよい
+			if (offsets[(m_keys[pSrc[0]] >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+			size_t total = 0;
+			for (size_t& offset : offsets)
+			{
+				const size_t bucketCount = offset;
+				offset = total;
+				total += bucketCount;
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				pDst[offsets[(m_keys[pSrc[i]] >> shift) & 0xFF]++] = pSrc[i];
+			}
+			std::swap(pSrc, pDst);
+		}
+		if (pSrc != m_order.data())
+		{
+			std::copy(pSrc, pSrc + count, m_order.data());
+		}
+	}
+
+	void SpriteDrawList::draw() const
+	{
+		for (const uint32 index : m_order)
+		{
+			const auto& sprite = m_sprites[index];
+			(*m_textures[sprite.textureSlot])(sprite.srcRect).mirrored(sprite.isMirror).draw(sprite.pos, sprite.color);
+		}
+	}
+
+	uint16 SpriteDrawList::findTextureSlot(const Texture* pTexture)
+	{
+		// 同じ絵を別の Texture で持っている場合も同じテクスチャとして扱う
+		for (size_t i = 0; i < m_textures.size(); ++i)
+		{
+			if (m_textures[i]->id() == pTexture->id())
+			{
+				return static_cast<uint16>(i);
+			}
+		}
+		m_textures.push_back(pTexture);
+		return static_cast<uint16>(m_textures.size() - 1);
+	}
+}
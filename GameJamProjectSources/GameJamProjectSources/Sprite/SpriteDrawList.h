@@ -0,0 +1,58 @@
+﻿#pragma once
+#ifndef BNSCUP_SPRITEDRAWLIST_H_
+#define BNSCUP_SPRITEDRAWLIST_H_
+
+#include <Siv3D.hpp>
+#include "../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 足元の Y 座標の順に並べて描くスプライトの一覧
+	 * @details 毎フレーム clear() してから add() で積み、sort() してから draw() する。
+	 *          並べ替えのキーは「足元の Y」「テクスチャ」の順で、それも同じなら積んだ順（基数ソートなので安定）。
+	 *          同じ高さのスプライトは同じテクスチャがまとまるので、描画のバッチが切れにくい。
+	 *          配列は使い回すので、一度広がった後はフレームごとの確保は起きない。
+	 *          テクスチャはポインタで持つので、draw() までは元の入れ物を変更しないこと。
+	 */
+	class SpriteDrawList
+	{
+	public:
+
+		explicit SpriteDrawList();
+		virtual ~SpriteDrawList();
+
+		void reserve(size_t count);
+		void clear();
+
+		// pos は左上、footY は重なり順を決める足元の Y 座標
+		void add(const Texture* pTexture, const RectF& srcRect, const Vec2& pos, double footY, bool isMirror = false, const ColorF& color = ColorF{ 1.0 });
+		size_t getCount() const;
+
+		void sort();
+		void draw() const;
+
+	private:
+
+		struct Sprite
+		{
+			RectF srcRect;
+			Vec2 pos;
+			ColorF color;
+			uint16 textureSlot;
+			bool isMirror;
+		};
+
+		uint16 findTextureSlot(const Texture* pTexture);
+
+	private:
+
+		SceneArray<Sprite> m_sprites;
+		SceneArray<uint32> m_keys;
+		SceneArray<uint32> m_order;
+		SceneArray<uint32> m_sortBuffer;
+		SceneArray<const Texture*> m_textures;
+	};
+}
+
+#endif // !BNSCUP_SPRITEDRAWLIST_H_
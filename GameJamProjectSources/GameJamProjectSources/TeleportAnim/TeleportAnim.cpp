@@ -2,34 +2,41 @@
 
 namespace bnscup
 {
+	namespace
+	{
+		// 1コマの表示時間（秒）
+		constexpr double FRAME_TIME = 0.032;
+	}
+
 	TeleportAnim::TeleportAnim()
 		: m_timer{ 0.0 }
 		, m_index{ 0 }
 		, m_textures{}
 		, m_isEnable{ false }
-		, m_se{}
+		, m_se{ INVALID_SOUND_ID }
 	{
 		for (int32 i : step(100))
 		{
 			m_textures.emplace_back(TextureAsset(U"teleport_anim_{:0>4}"_fmt(i + 1)));
 		}
-		m_se = AudioAsset(U"sd_teleport");
+		m_se = SoundManager::Register(U"sd_teleport", SoundCategory::Gameplay, 8, 0.3);
 	}
 
 	TeleportAnim::~TeleportAnim()
 	{
 	}
 
-	void TeleportAnim::update()
+	void TeleportAnim::update(double deltaTime)
 	{
 		if (isEnd() or not(isEnable()))
 		{
 			return;
 		}
-		m_timer += Scene::DeltaTime();
-		if (m_timer > 0.032)
+		// 余りは次のコマに持ち越す（長いフレームでは複数コマ進む）
+		m_timer += deltaTime;
+		while (FRAME_TIME <= m_timer and not(isEnd()))
 		{
-			m_timer = 0.0;
+			m_timer -= FRAME_TIME;
 			m_index++;
 		}
 	}
@@ -64,8 +71,7 @@ namespace bnscup
 		m_isEnable = isEnable;
 		if (m_isEnable)
 		{
-			m_se.setVolume(0.3);
-			m_se.play();
+			SoundManager::Play(m_se);
 		}
 	}
 
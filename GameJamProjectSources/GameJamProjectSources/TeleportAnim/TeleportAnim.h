@@ -3,6 +3,7 @@
 #define BNSCUP_TELEPORTANIM_H_
 
 #include <Siv3D.hpp>
+#include "../Sound/SoundManager.h"
 
 namespace bnscup
 {
@@ -13,7 +14,7 @@ namespace bnscup
 		explicit TeleportAnim();
 		virtual ~TeleportAnim();
 
-		void update();
+		void update(double deltaTime);
 		void draw() const;
 
 		void reset();
@@ -30,7 +31,7 @@ namespace bnscup
 		int32 m_index;
 		Array<Texture> m_textures;
 		Vec2 m_pos;
-		Audio m_se;
+		SoundId m_se;
 	};
 }
 
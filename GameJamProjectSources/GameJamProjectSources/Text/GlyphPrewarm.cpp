@@ -0,0 +1,120 @@
+﻿#include "GlyphPrewarm.h"
+#include "../Common/Common.h"
+#include "TextTable.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		struct GlyphSet
+		{
+			const char32_t* fontAssetName;	// nullptr なら SimpleGUI のフォント（MessageBox の既定）
+			Array<TextId> textIds;
+			const char32_t* extraText;		// 表に無い文字（書式で埋める数字など）
+		};
+
+		// シーンごとに描く文字（画面の文字を増やしたらここにも足す）
+		static const HashTable<SceneKey, const Array<GlyphSet>> TABLE =
+		{
+			{
+				SceneKey::Title,
+				{
+					{ U"font_title_logo", {}, GAME_TITLE },
+					{ U"font_title_button", { TextId::TitleStageSelect, TextId::TitleExit }, U"" },
+				}
+			},
+			{
+				SceneKey::StageSelect,
+				{
+					{ U"font_play_button", { TextId::StageSelectPlay }, U"" },
+					{ U"font_stage_no_button", { TextId::StageNo }, U"0123456789" },
+				}
+			},
+			{
+				SceneKey::Game,
+				{
+					{
+						U"font_button",
+						{
+							TextId::StageNo, TextId::GamePause, TextId::GameExit, TextId::GameForecast, TextId::GameUndo, TextId::GameRedo,
+							TextId::PauseReturnStageSelect, TextId::PauseReturnTitle, TextId::PauseClose,
+						},
+						U"0123456789"
+					},
+					{ U"font_pause_view", { TextId::PauseTitle }, U"" },
+					{
+						nullptr,
+						{
+							TextId::MessageOK, TextId::MessageCancel, TextId::MessageYes, TextId::MessageNo,
+							TextId::PopupUseKey, TextId::PopupRescue, TextId::PopupReturnNotAllRescued, TextId::PopupReturnAllRescued,
+							TextId::PopupNotHaveKey, TextId::PopupCaught,
+						},
+						U""
+					},
+				}
+			},
+		};
+
+		// フォントごとに描いておいた文字
+		HashTable<uint32, HashSet<char32>> g_prewarmedTable;
+	}
+
+	void GlyphPrewarm::Prewarm(SceneKey scene)
+	{
+		auto it = TABLE.find(scene);
+		if (it == TABLE.end())
+		{
+			return;
+		}
+
+		for (const auto& glyphSet : it->second)
+		{
+			const Font font = (glyphSet.fontAssetName == nullptr)
+				? SimpleGUI::GetFont()
+				: FontAsset(glyphSet.fontAssetName);
+			if (font.isEmpty())
+			{
+				DEBUG_BREAK(true);
+				continue;
+			}
+
+			String text{ glyphSet.extraText };
+			for (const auto textId : glyphSet.textIds)
+			{
+				text += TextTable::Get(textId);
+			}
+			font.preload(text);
+#ifdef _DEBUG
+			auto& prewarmed = g_prewarmedTable[font.id().value()];
+			for (const char32 ch : text)
+			{
+				prewarmed.insert(ch);
+			}
+#endif // _DEBUG
+		}
+	}
+
+	void GlyphPrewarm::Clear()
+	{
+		g_prewarmedTable.clear();
+	}
+
+	void GlyphPrewarm::Verify([[maybe_unused]] const Font& font, [[maybe_unused]] StringView text)
+	{
+#ifdef _DEBUG
+		const auto it = g_prewarmedTable.find(font.id().value());
+		for (const char32 ch : text)
+		{
+			if (IsControl(ch) or IsSpace(ch))
+			{
+				continue;
+			}
+			if (it == g_prewarmedTable.end() or not(it->second.contains(ch)))
+			{
+				Logger << U"glyph not prewarmed: '{}' in \"{}\""_fmt(ch, text);
+				return;
+			}
+		}
+#endif // _DEBUG
+	}
+}
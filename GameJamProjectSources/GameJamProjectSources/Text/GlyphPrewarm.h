@@ -0,0 +1,32 @@
+﻿#pragma once
+#ifndef BNSCUP_GLYPHPREWARM_H_
+#define BNSCUP_GLYPHPREWARM_H_
+
+#include <Siv3D.hpp>
+#include "../Scene/SceneDefine.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief シーンで使う UI の文字を読み込み中に先にアトラスへ描いておく
+	 * @details 文字は初めて描くときにアトラスへ描かれるため、ゲーム中に初めて開いた
+	 *          ポップアップなどで引っかかる。シーンごとの文字の一覧（GlyphPrewarm.cpp）を
+	 *          読み込みの最後に Prewarm() で描いておく。
+	 *          デバッグビルドでは TextLayout を作るときに Verify() で一覧に無い文字を調べてログに出す。
+	 */
+	class GlyphPrewarm
+	{
+	public:
+
+		// FontAsset の読み込みが終わってから呼ぶ
+		static void Prewarm(SceneKey scene);
+
+		// 描いておいた文字の記録を捨てる（フォントを破棄する前に）
+		static void Clear();
+
+		// 一覧に無い文字があればログに出す（デバッグビルドのみ）
+		static void Verify(const Font& font, StringView text);
+	};
+}
+
+#endif // !BNSCUP_GLYPHPREWARM_H_
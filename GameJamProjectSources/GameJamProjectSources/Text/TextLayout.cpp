@@ -0,0 +1,134 @@
+﻿#include "TextLayout.h"
+#include "GlyphPrewarm.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// フォントごとに文字列 -> 並べた結果
+		HashTable<uint32, HashTable<String, std::unique_ptr<TextLayout>>> g_layoutTable;
+		size_t g_layoutCount = 0;
+	}
+
+	TextLayout::TextLayout()
+		: m_font{}
+		, m_size{ SizeF::Zero() }
+		, m_glyphTextures{}
+		, m_glyphOffsets{}
+	{
+	}
+
+	TextLayout::TextLayout(const Font& font, StringView text)
+		: TextLayout{}
+	{
+		build(font, text);
+	}
+
+	TextLayout::~TextLayout()
+	{
+	}
+
+	void TextLayout::build(const Font& font, StringView text)
+	{
+		m_font = font;
+		m_glyphTextures.clear();
+		m_glyphOffsets.clear();
+		if (font.isEmpty() or text.isEmpty())
+		{
+			m_size = SizeF::Zero();
+			return;
+		}
+
+		// 読み込み中に描いておかなかった文字はここで初めてアトラスに描かれる
+		GlyphPrewarm::Verify(font, text);
+
+		// 大きさは Font(text).region() と揃える
+		m_size = font(text).region().size;
+
+		const auto& glyphs = font.getGlyphs(text);
+		m_glyphTextures.reserve(glyphs.size());
+		m_glyphOffsets.reserve(glyphs.size());
+
+		Vec2 penPos{ 0, 0 };
+		for (const auto& glyph : glyphs)
+		{
+			if (glyph.codePoint == U'\n')
+			{
+				penPos.x = 0;
+				penPos.y += font.height();
+				continue;
+			}
+			if (glyph.texture.size.x > 0 and glyph.texture.size.y > 0)
+			{
+				m_glyphTextures.push_back(glyph.texture);
+				m_glyphOffsets.push_back(penPos + glyph.getOffset());
+			}
+			penPos.x += glyph.xAdvance;
+		}
+	}
+
+	bool TextLayout::isEmpty() const
+	{
+		return m_glyphTextures.isEmpty();
+	}
+
+	const SizeF& TextLayout::getSize() const
+	{
+		return m_size;
+	}
+
+	RectF TextLayout::getRegion(const Vec2& pos) const
+	{
+		return RectF{ pos, m_size };
+	}
+
+	void TextLayout::draw(const Vec2& pos, const ColorF& color) const
+	{
+		if (isEmpty())
+		{
+			return;
+		}
+		// SDF / MSDF のフォントは専用のシェーダーで描く
+		const ScopedCustomShader2D shader{ Font::GetPixelShader(m_font.method()) };
+		for (size_t i : step(m_glyphTextures.size()))
+		{
+			m_glyphTextures[i].draw(pos + m_glyphOffsets[i], color);
+		}
+	}
+
+	void TextLayout::drawAt(const Vec2& center, const ColorF& color) const
+	{
+		draw(center - m_size * 0.5, color);
+	}
+
+	//==================================================
+
+	const TextLayout* TextLayoutCache::Get(const Font& font, StringView text)
+	{
+		auto& table = g_layoutTable[font.id().value()];
+		String key{ text };
+		auto it = table.find(key);
+		if (it != table.end())
+		{
+			return it->second.get();
+		}
+
+		// Clear() までシーンより長く残るので、シーンのアリーナではなく一般ヒープに置く
+		const SceneArena::Scope heapScope{ nullptr };
+		auto* pLayout = new TextLayout{ font, text };
+		table.emplace(std::move(key), std::unique_ptr<TextLayout>(pLayout));
+		++g_layoutCount;
+		return pLayout;
+	}
+
+	void TextLayoutCache::Clear()
+	{
+		g_layoutTable.clear();
+		g_layoutCount = 0;
+	}
+
+	size_t TextLayoutCache::GetCount()
+	{
+		return g_layoutCount;
+	}
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#ifndef BNSCUP_TEXTLAYOUT_H_
+#define BNSCUP_TEXTLAYOUT_H_
+
+#include <Siv3D.hpp>
+#include "../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	/**
+	 * @brief 一度だけ字形を並べて、あとはその結果から描く文字列
+	 * @details Font(text).draw() は描くたびに文字列を字形に変換して並べ直すため、
+	 *          変わらない文字列はここで並べた結果（テクスチャ領域と位置）を持っておく。
+	 */
+	class TextLayout
+	{
+	public:
+
+		explicit TextLayout();
+		explicit TextLayout(const Font& font, StringView text);
+		virtual ~TextLayout();
+
+		void build(const Font& font, StringView text);
+
+		bool isEmpty() const;
+
+		const SizeF& getSize() const;
+		RectF getRegion(const Vec2& pos = Vec2::Zero()) const;
+
+		// pos は左上
+		void draw(const Vec2& pos, const ColorF& color = Palette::White) const;
+		void drawAt(const Vec2& center, const ColorF& color = Palette::White) const;
+
+	private:
+
+		Font m_font;
+		SizeF m_size;
+		SceneArray<TextureRegion> m_glyphTextures;
+		SceneArray<Vec2> m_glyphOffsets;
+	};
+
+	/**
+	 * @brief 変わらない文字列の TextLayout を（フォント, 文字列）ごとに1つだけ持つ
+	 * @details 返すポインタは Clear() まで有効。フォントを破棄する前（シーンの切り替え時）に Clear() する。
+	 */
+	class TextLayoutCache
+	{
+	public:
+
+		static const TextLayout* Get(const Font& font, StringView text);
+
+		static void Clear();
+
+		static size_t GetCount();
+	};
+}
+
+#endif // !BNSCUP_TEXTLAYOUT_H_
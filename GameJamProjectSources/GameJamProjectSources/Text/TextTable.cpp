@@ -0,0 +1,64 @@
+﻿#include "TextTable.h"
+#include "../Common/Common.h"
+
+namespace bnscup
+{
+	namespace
+	{
+		// TextId の順
+		static const StringView TEXT_TABLE[] =
+		{
+			// タイトル
+			U"ステージ選択",
+			U"ゲーム終了",
+
+			// ステージ選択
+			U"ゲーム開始",
+			U"ステージ{}",
+
+			// ゲーム
+			U"PAUSE",
+			U"脱出",
+			U"予測",
+			U"戻す",
+			U"進む",
+
+			// ポーズ
+			U"ポーズ",
+			U"ステージ選択へ",
+			U"タイトルへ",
+			U"閉じる",
+
+			// メッセージボックスのボタン
+			U"OK",
+			U"CANCEL",
+			U"はい",
+			U"いいえ",
+
+			// ゲーム中のポップアップ
+			U"鍵を使用しますか？",
+			U"救助対象を見つけました！\n"
+			U"転送します。",
+			U"まだ助けていないユニットがいます。\n"
+			U"脱出しますか？",
+			U"すべてのユニットを救助しました！\n"
+			U"脱出します。",
+			U"鍵がかかっています。\n"
+			U"どこかに落ちている鍵を探しましょう！",
+			U"敵に捕まってしまった！\n"
+			U"一手戻しますか？",
+		};
+		static_assert(std::size(TEXT_TABLE) == FromEnum(TextId::Count));
+	}
+
+	StringView TextTable::Get(TextId id)
+	{
+		const size_t index = FromEnum(id);
+		if (std::size(TEXT_TABLE) <= index)
+		{
+			DEBUG_BREAK(true);
+			return StringView{};
+		}
+		return TEXT_TABLE[index];
+	}
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+#ifndef BNSCUP_TEXTTABLE_H_
+#define BNSCUP_TEXTTABLE_H_
+
+#include <Siv3D.hpp>
+
+namespace bnscup
+{
+	// 画面に出す文字の番号（TextTable.cpp の表と同じ順）
+	enum class TextId : uint16
+	{
+		// タイトル
+		TitleStageSelect,
+		TitleExit,
+
+		// ステージ選択
+		StageSelectPlay,
+		StageNo,				// {} にステージ番号
+
+		// ゲーム
+		GamePause,
+		GameExit,
+		GameForecast,
+		GameUndo,
+		GameRedo,
+
+		// ポーズ
+		PauseTitle,
+		PauseReturnStageSelect,
+		PauseReturnTitle,
+		PauseClose,
+
+		// メッセージボックスのボタン
+		MessageOK,
+		MessageCancel,
+		MessageYes,
+		MessageNo,
+
+		// ゲーム中のポップアップ
+		PopupUseKey,
+		PopupRescue,
+		PopupReturnNotAllRescued,
+		PopupReturnAllRescued,
+		PopupNotHaveKey,
+		PopupCaught,
+
+		Count,
+	};
+
+	/**
+	 * @brief 画面に出す文字の表
+	 * @details 文字は実行ファイルに埋め込んだ表を番号で引くだけで、コピーも検索もしない。
+	 *          返す StringView はずっと有効。言語を増やす場合は表を言語ごとに持つ。
+	 */
+	class TextTable
+	{
+	public:
+
+		static StringView Get(TextId id);
+	};
+
+	/**
+	 * @brief TextTable の書式を埋めた文字列を、引数が変わるまで持っておく
+	 */
+	template <class... Args>
+	class FormattedText
+	{
+	public:
+
+		explicit FormattedText(TextId id)
+			: m_id{ id }
+			, m_args{ none }
+			, m_text{}
+		{
+		}
+
+		virtual ~FormattedText()
+		{
+		}
+
+		// 引数が変わったときだけ作り直す。作り直したら true
+		bool update(const Args&... args)
+		{
+			if (m_args and (*m_args == std::tuple<Args...>{ args... }))
+			{
+				return false;
+			}
+			m_args.emplace(args...);
+			m_text = Fmt(TextTable::Get(m_id))(args...);
+			return true;
+		}
+
+		const String& get() const
+		{
+			return m_text;
+		}
+
+	private:
+
+		TextId m_id;
+		Optional<std::tuple<Args...>> m_args;
+		String m_text;
+	};
+}
+
+#endif // !BNSCUP_TEXTTABLE_H_
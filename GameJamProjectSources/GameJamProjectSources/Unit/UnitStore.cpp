@@ -0,0 +1,335 @@
+﻿#include "UnitStore.h"
+#include "../Common/Common.h"
+#include "../Animation/AnimationClip.h"
+#include "../Sprite/SpriteDrawList.h"
+
+namespace bnscup
+{
+	UnitStore::UnitStore()
+		: m_generations{}
+		, m_flags{}
+		, m_positions{}
+		, m_lastStepPositions{}
+		, m_prevPositions{}
+		, m_targetPositions{}
+		, m_moveTimers{}
+		, m_animPhases{}
+		, m_footStepTimers{}
+		, m_animationIds{}
+		, m_footStepSEIds{}
+		, m_freeSlots{}
+		, m_aliveCount{ 0 }
+		, m_animClock{ 0.0 }
+		, m_lastStepAnimClock{ 0.0 }
+		, m_animations{}
+	{
+	}
+
+	UnitStore::~UnitStore()
+	{
+	}
+
+	void UnitStore::reserve(size_t count)
+	{
+		m_generations.reserve(count);
+		m_flags.reserve(count);
+		m_positions.reserve(count);
+		m_lastStepPositions.reserve(count);
+		m_prevPositions.reserve(count);
+		m_targetPositions.reserve(count);
+		m_moveTimers.reserve(count);
+		m_animPhases.reserve(count);
+		m_footStepTimers.reserve(count);
+		m_animationIds.reserve(count);
+		m_footStepSEIds.reserve(count);
+	}
+
+	void UnitStore::clear()
+	{
+		// 世代は残しておき、古いハンドルが新しいユニットを指さないようにする
+		m_freeSlots.clear();
+		for (uint32 i = 0; i < static_cast<uint32>(m_flags.size()); ++i)
+		{
+			if (m_flags[i] & Flag_Alive)
+			{
+				m_flags[i] = 0;
+				m_generations[i]++;
+			}
+			m_freeSlots.push_back(i);
+		}
+		m_aliveCount = 0;
+	}
+
+	uint16 UnitStore::addAnimation(AssetNameView clipName)
+	{
+		// 名前引きはここで一度だけ行い、以降はクリップとテクスチャを直接使う
+		const AnimationClip* pClip = AnimationClipLibrary::Find(clipName);
+		DEBUG_BREAK(pClip == nullptr or pClip->getFrameCount() == 0);
+		Texture texture;
+		if (pClip)
+		{
+			texture = TextureAsset(pClip->getTextureName());
+		}
+		m_animations.push_back(Animation{ pClip, texture });
+		return static_cast<uint16>(m_animations.size() - 1);
+	}
+
+	UnitHandle UnitStore::create(uint16 animationId, const Vec2& pos, double animPhase)
+	{
+		DEBUG_BREAK(m_animations.size() <= animationId);
+
+		uint32 index = 0;
+		if (not(m_freeSlots.isEmpty()))
+		{
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32>(m_flags.size());
+			m_generations.push_back(0);
+			m_flags.push_back(0);
+			m_positions.emplace_back();
+			m_lastStepPositions.emplace_back();
+			m_prevPositions.emplace_back();
+			m_targetPositions.emplace_back();
+			m_moveTimers.push_back(0.0);
+			m_animPhases.push_back(0.0);
+			m_footStepTimers.push_back(0.0);
+			m_animationIds.push_back(0);
+			m_footStepSEIds.push_back(INVALID_SOUND_ID);
+		}
+
+		// 0 は無効なハンドル用
+		m_generations[index]++;
+		if (m_generations[index] == 0)
+		{
+			m_generations[index] = 1;
+		}
+		m_flags[index] = (Flag_Alive | Flag_Enable);
+		m_positions[index] = pos;
+		m_lastStepPositions[index] = pos;
+		m_prevPositions[index] = pos;
+		m_targetPositions[index] = pos;
+		m_moveTimers[index] = 0.0;
+		m_animPhases[index] = animPhase;
+		m_footStepTimers[index] = 0.0;
+		m_animationIds[index] = animationId;
+		m_footStepSEIds[index] = INVALID_SOUND_ID;
+		m_aliveCount++;
+
+		return UnitHandle{ index, m_generations[index] };
+	}
+
+	void UnitStore::destroy(const UnitHandle& handle)
+	{
+		if (not(isAlive(handle)))
+		{
+			return;
+		}
+		m_flags[handle.index] = 0;
+		m_generations[handle.index]++;
+		m_freeSlots.push_back(handle.index);
+		m_aliveCount--;
+	}
+
+	bool UnitStore::isAlive(const UnitHandle& handle) const
+	{
+		return handle.isValid()
+			and (handle.index < m_generations.size())
+			and (m_generations[handle.index] == handle.generation)
+			and (m_flags[handle.index] & Flag_Alive);
+	}
+
+	size_t UnitStore::getCount() const
+	{
+		return m_aliveCount;
+	}
+
+	void UnitStore::beginStep()
+	{
+		m_lastStepPositions = m_positions;
+		m_lastStepAnimClock = m_animClock;
+	}
+
+	void UnitStore::update(double deltaTime)
+	{
+		const size_t count = m_flags.size();
+
+		// アニメーション（コマは描画時に時計から求める）
+		m_animClock += deltaTime;
+
+		// 移動
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (not(m_flags[i] & Flag_Alive)
+				or m_targetPositions[i] == m_positions[i])
+			{
+				continue;
+			}
+			m_moveTimers[i] += deltaTime;
+			m_footStepTimers[i] += deltaTime;
+			m_positions[i] = Math::Lerp(m_prevPositions[i], m_targetPositions[i], m_moveTimers[i]);
+			if (m_footStepTimers[i] > 0.3)
+			{
+				playFootStepSE(static_cast<uint32>(i));
+			}
+			if (m_moveTimers[i] >= 1.0)
+			{
+				m_positions[i] = m_targetPositions[i];
+				m_moveTimers[i] = 0.0;
+			}
+		}
+	}
+
+	void UnitStore::addSprites(SpriteDrawList& drawList, double alpha) const
+	{
+		const double animClock = Math::Lerp(m_lastStepAnimClock, m_animClock, alpha);
+		const size_t count = m_flags.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8 flags = m_flags[i];
+			if (not(flags & Flag_Alive) or not(flags & Flag_Enable))
+			{
+				continue;
+			}
+			const auto& animation = m_animations[m_animationIds[i]];
+			if (animation.pClip == nullptr)
+			{
+				continue;
+			}
+			const RectF& srcRect = animation.pClip->getFrame(animClock + m_animPhases[i]);
+			const Vec2 pos = Math::Lerp(m_lastStepPositions[i], m_positions[i], alpha);
+			// pos は足元の位置
+			drawList.add(&animation.texture, srcRect, pos - Vec2{ srcRect.w * 0.5, srcRect.h }, pos.y, (flags & Flag_Mirror) != 0);
+		}
+	}
+
+	void UnitStore::setTargetPos(const UnitHandle& handle, const Vec2& targetPos)
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		const uint32 i = handle.index;
+		m_targetPositions[i] = targetPos;
+		m_prevPositions[i] = m_positions[i];
+		m_moveTimers[i] = 0.0;
+		if (m_targetPositions[i] != m_positions[i])
+		{
+			playFootStepSE(i);
+		}
+	}
+
+	void UnitStore::setPos(const UnitHandle& handle, const Vec2& pos)
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		// 瞬間移動なので補間しない
+		m_positions[handle.index] = pos;
+		m_lastStepPositions[handle.index] = pos;
+		m_targetPositions[handle.index] = pos;
+	}
+
+	const Vec2& UnitStore::getPos(const UnitHandle& handle) const
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			static const Vec2 INVALID_POS = Vec2::Zero();
+			return INVALID_POS;
+		}
+		return m_positions[handle.index];
+	}
+
+	void UnitStore::setFootStepSE(const UnitHandle& handle, SoundId footStepSEId)
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		m_footStepSEIds[handle.index] = footStepSEId;
+	}
+
+	bool UnitStore::isMoving(const UnitHandle& handle) const
+	{
+		if (not(isAlive(handle)))
+		{
+			return false;
+		}
+		return (m_targetPositions[handle.index] != m_positions[handle.index]);
+	}
+
+	bool UnitStore::isAnyMoving() const
+	{
+		const size_t count = m_flags.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			if ((m_flags[i] & Flag_Alive)
+				and m_targetPositions[i] != m_positions[i])
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void UnitStore::setMirror(const UnitHandle& handle, bool isMirror)
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		setFlag(handle.index, Flag_Mirror, isMirror);
+	}
+
+	bool UnitStore::isEnable(const UnitHandle& handle) const
+	{
+		if (not(isAlive(handle)))
+		{
+			return false;
+		}
+		return (m_flags[handle.index] & Flag_Enable) != 0;
+	}
+
+	void UnitStore::setEnable(const UnitHandle& handle, bool isEnable)
+	{
+		if (not(isAlive(handle)))
+		{
+			DEBUG_BREAK(true);
+			return;
+		}
+		setFlag(handle.index, Flag_Enable, isEnable);
+	}
+
+	void UnitStore::setFlag(uint32 index, uint8 flag, bool isOn)
+	{
+		if (isOn)
+		{
+			m_flags[index] |= flag;
+		}
+		else
+		{
+			m_flags[index] &= ~flag;
+		}
+	}
+
+	void UnitStore::playFootStepSE(uint32 index)
+	{
+		// 鳴らなくても次の足音まで待つ（上限で落とされた音を毎ステップ鳴らし直さない）
+		m_footStepTimers[index] = 0.0;
+		const SoundId seId = m_footStepSEIds[index];
+		if (seId == INVALID_SOUND_ID)
+		{
+			return;
+		}
+		// 大勢が歩いても鳴る数は SoundManager の上限までに抑えられる
+		SoundManager::Play(seId);
+	}
+}
@@ -0,0 +1,119 @@
+﻿#pragma once
+#ifndef BNSCUP_UNITSTORE_H_
+#define BNSCUP_UNITSTORE_H_
+
+#include <Siv3D.hpp>
+#include "../Sound/SoundManager.h"
+#include "../Memory/SceneAllocator.h"
+
+namespace bnscup
+{
+	class AnimationClip;
+	class SpriteDrawList;
+
+	/**
+	 * @brief UnitStore 内のユニットを指すハンドル
+	 * @details 削除されたスロットが再利用されても世代が違えば別物として扱う。
+	 */
+	struct UnitHandle
+	{
+		uint32 index = 0;
+		uint32 generation = 0;	// 0 は無効
+
+		bool isValid() const { return (generation != 0); }
+		bool operator==(const UnitHandle& other) const { return (index == other.index) and (generation == other.generation); }
+		bool operator!=(const UnitHandle& other) const { return not(*this == other); }
+	};
+
+	/**
+	 * @brief ユニット（プレイヤー、敵、救助対象）をまとめて持つ入れ物
+	 * @details 位置やタイマーなどを項目ごとの配列で持ち、更新は配列を先頭から順に流すだけにする。
+	 *          テクスチャとアニメーションは見た目ごとに1つだけ持ち、ユニットは番号で参照する。
+	 *          足音は SoundManager の番号を持ち、同時に鳴る数は SoundManager 側で抑える。
+	 *          アニメーションは入れ物全体の時計とユニットごとの位相から描画時に求めるので、ユニットごとのタイマーは持たない。
+	 *          update() は決まった長さのステップで呼び、描画は直前のステップとの間を補間する。
+	 */
+	class UnitStore
+	{
+	public:
+
+		explicit UnitStore();
+		virtual ~UnitStore();
+
+		void reserve(size_t count);
+		void clear();
+
+		// 同じ見た目のユニットで共有するアニメーションクリップを登録する
+		uint16 addAnimation(AssetNameView clipName);
+
+		// animPhase はアニメーションの開始位置（秒）。同じ値のユニットは同じコマで動く
+		UnitHandle create(uint16 animationId, const Vec2& pos, double animPhase = 0.0);
+		void destroy(const UnitHandle& handle);
+		bool isAlive(const UnitHandle& handle) const;
+		size_t getCount() const;
+
+		// ステップの頭で呼び、補間の始点を今の状態にする
+		void beginStep();
+		void update(double deltaTime);
+		// 描画するユニットを一覧に積む（描く順は一覧の側で足元の Y から決める）
+		// alpha: 直前のステップから今のステップまでの割合（1.0 で今の状態そのまま）
+		void addSprites(SpriteDrawList& drawList, double alpha = 1.0) const;
+
+		void setTargetPos(const UnitHandle& handle, const Vec2& targetPos);
+		void setPos(const UnitHandle& handle, const Vec2& pos);
+		const Vec2& getPos(const UnitHandle& handle) const;
+
+		void setFootStepSE(const UnitHandle& handle, SoundId footStepSEId);
+
+		bool isMoving(const UnitHandle& handle) const;
+		bool isAnyMoving() const;
+
+		void setMirror(const UnitHandle& handle, bool isMirror);
+
+		bool isEnable(const UnitHandle& handle) const;
+		void setEnable(const UnitHandle& handle, bool isEnable);
+
+	private:
+
+		enum Flag : uint8
+		{
+			Flag_Alive  = 1 << 0,
+			Flag_Enable = 1 << 1,
+			Flag_Mirror = 1 << 2,
+		};
+
+		struct Animation
+		{
+			const AnimationClip* pClip;
+			Texture texture;
+		};
+
+		void setFlag(uint32 index, uint8 flag, bool isOn);
+		void playFootStepSE(uint32 index);
+
+	private:
+
+		// スロットごとの項目（添字はハンドルの index）
+		SceneArray<uint32> m_generations;
+		SceneArray<uint8> m_flags;
+		SceneArray<Vec2> m_positions;
+		SceneArray<Vec2> m_lastStepPositions;
+		SceneArray<Vec2> m_prevPositions;
+		SceneArray<Vec2> m_targetPositions;
+		SceneArray<double> m_moveTimers;
+		SceneArray<double> m_animPhases;
+		SceneArray<double> m_footStepTimers;
+		SceneArray<uint16> m_animationIds;
+		SceneArray<SoundId> m_footStepSEIds;
+
+		SceneArray<uint32> m_freeSlots;
+		size_t m_aliveCount;
+		double m_animClock;
+		double m_lastStepAnimClock;
+
+		// 共有する資源
+		SceneArray<Animation> m_animations;
+	};
+}
+
+#endif // !BNSCUP_UNITSTORE_H_